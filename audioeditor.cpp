@@ -1,8 +1,13 @@
 #include "audioeditor.h"
 #include "ui_audioeditor.h"
+#include "audioprober.h"
+#include "peakcache.h"
+#include "samplestore.h"
+#include "savejob.h"
 
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QProcess>
 #include <QFile>
 #include <QFileInfo>
@@ -20,6 +25,12 @@
 #include <QLineEdit>
 #include <QDialogButtonBox>
 #include <QThread> 
+#include <QtEndian>
+#include <QSettings>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QStyle>
 
   
 // ============================================================================
@@ -125,9 +136,15 @@ AudioEditor::AudioEditor(const QString &filePath, const QString &workingDir, QWi
 AudioEditor::~AudioEditor()
 {
     releaseResources();
+    loaderThread.quit();
+    loaderThread.wait();
+    if (saveJob) saveJob->cancel();
+    saveThread.quit();
+    saveThread.wait();
+    delete saveJob;
     QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
     QDir dir(tempDir);
-    dir.setNameFilters({"temp_playback_*", "temp_modified*", "temp.raw", "temp_save.raw"});
+    dir.setNameFilters({"temp_modified*", "temp_save.raw"});
     for (const QString &f : dir.entryList(QDir::Files))
         dir.remove(f);
     delete ui;
@@ -148,17 +165,43 @@ void AudioEditor::init()
     ui->setupUi(this);
     isModified = false;
 
-    player = new QMediaPlayer(this);
-    audioOutput = new QAudioOutput(this);
-    decoder = new QAudioDecoder(this);
+    playback = new AudioPlayback(this);
     totalSamples = 0;
 
+    loader = new AudioLoader;
+    loader->moveToThread(&loaderThread);
+    connect(&loaderThread, &QThread::finished, loader, &QObject::deleteLater);
+    connect(loader, &AudioLoader::streamInfo,     this, &AudioEditor::handleStreamInfo);
+    connect(loader, &AudioLoader::samplesDecoded, this, &AudioEditor::appendDecodedSamples);
+    connect(loader, &AudioLoader::finished,       this, &AudioEditor::decodingFinished);
+    loaderThread.start();
+
+    // Un seul signal, partagé : la forme d'onde lit le document et suit ses modifications
+    document = new SampleDocument(this);
     waveformWidget = ui->waveformWidget;
+    waveformWidget->setDocument(document);
     waveformWidget->setisLoaded(false);
 
+    ui->btnUndo->setIcon(QIcon::fromTheme("edit-undo", style()->standardIcon(QStyle::SP_ArrowBack)));
+    ui->btnRedo->setIcon(QIcon::fromTheme("edit-redo", style()->standardIcon(QStyle::SP_ArrowForward)));
+    ui->btnUndo->setShortcut(QKeySequence::Undo);
+    ui->btnRedo->setShortcut(QKeySequence::Redo);
+
+    // Budget mémoire de l'historique (Mo), réglable dans la configuration de l'application
+    QSettings settings;
+    history.setMemoryBudget(settings.value("editor/undoMemoryMB", 1024).toLongLong() * 1024 * 1024);
+
+    // Échantillons décodés : fichier d'échange projeté en mémoire, dont au plus
+    // residentMemoryMB restent en RAM ; scratchDir vide = dossier de cache
+    SampleStore::instance().setResidentBudget(settings.value("editor/residentMemoryMB", 1024).toLongLong() * 1024 * 1024);
+    SampleStore::instance().setDirectory(settings.value("editor/scratchDir").toString());
+
+    // WAV 16/24 bits : échantillons gardés dans leur résolution d'origine (2 ou
+    // 3 octets au lieu de 4), convertis en float seulement à la lecture
+    compactSamples = settings.value("editor/compactSamples", true).toBool();
+
     setButtonsEnabled(false);
-    audioOutput->setVolume(0.5);
-    player->setAudioOutput(audioOutput);
+    playback->setVolume(0.5f);
 
     connect(ui->btnOpen,      &QPushButton::clicked, this, &AudioEditor::openFile);
     connect(ui->btnPlay,      &QPushButton::clicked, this, &AudioEditor::playPause);
@@ -168,20 +211,13 @@ void AudioEditor::init()
     connect(ui->btnSave,      &QPushButton::clicked, this, &AudioEditor::saveModifiedAudio);
     connect(ui->btnNormalizeAll, &QPushButton::clicked, this, &AudioEditor::normalizeSelection);
     connect(ui->btnNormalize,    &QPushButton::clicked, this, &AudioEditor::normalizeSelection);
+    connect(ui->btnUndo,         &QPushButton::clicked, this, &AudioEditor::undo);
+    connect(ui->btnRedo,         &QPushButton::clicked, this, &AudioEditor::redo);
     connect(ui->btnZoomIn,       &QPushButton::clicked, waveformWidget, &WaveformWidget::zoomIn);
     connect(ui->btnZoomOut,      &QPushButton::clicked, waveformWidget, &WaveformWidget::zoomOut);
 
-    connect(player, &QMediaPlayer::positionChanged,    this, &AudioEditor::updatePlayhead);
-    connect(player, &QMediaPlayer::mediaStatusChanged, this, &AudioEditor::handleMediaStatusChanged);
-    connect(player, &QMediaPlayer::durationChanged,    this, [this](qint64 d){
-        ui->lengthLabel->setText(QTime::fromMSecsSinceStartOfDay(d).toString("hh:mm:ss"));
-    });
-
-    connect(decoder, &QAudioDecoder::bufferReady, this, [this]() {
-        QAudioBuffer buf = decoder->read();
-        processBuffer(buf);
-    });
-    connect(decoder, &QAudioDecoder::finished, this, &AudioEditor::decodingFinished);
+    connect(playback, &AudioPlayback::positionChanged, this, &AudioEditor::updatePlayhead);
+    connect(playback, &AudioPlayback::finished,        this, &AudioEditor::handlePlaybackFinished);
 
     connect(waveformWidget, &WaveformWidget::zoomChanged,      this, &AudioEditor::handleZoomChanged);
     connect(waveformWidget, &WaveformWidget::selectionChanged, this, &AudioEditor::handleSelectionChanged);
@@ -203,6 +239,7 @@ void AudioEditor::setButtonsEnabled(bool e)
     ui->btnZoomIn->setEnabled(e);
     ui->btnZoomOut->setEnabled(e);
     ui->selectionLabel->clear();
+    updateUndoButtons();
 }
 
 void AudioEditor::updatePositionLabel(qint64 pos)
@@ -212,52 +249,98 @@ void AudioEditor::updatePositionLabel(qint64 pos)
 
 QString AudioEditor::timeToPosition(qint64 sampleIdx, const QString &fmt)
 {
-    qint64 dur = player->duration();
-    if (dur <= 0 || totalSamples <= 0) return "00:00:00";
-    qint64 ms = static_cast<qint64>((double)sampleIdx / totalSamples * dur);
-    return QTime(0,0,0).addMSecs(ms).toString(fmt);
+    if (sampleRate <= 0 || sampleIdx < 0) return "00:00:00";
+    qint64 ms = sampleIdx * 1000 / sampleRate;
+    // QTime repasse à zéro après 24 h : les heures sont écrites à part, sans limite
+    const qint64 hours = ms / 3600000;
+    QString text = QTime(0,0,0).addMSecs(ms % 3600000).toString(fmt);
+    if (fmt.startsWith("hh"))
+        text.replace(0, 2, QString("%1").arg(hours, 2, 10, QChar('0')));
+    return text;
 }
 
 void AudioEditor::openFile()
 {
-    if (decoder) {
-        decoder->stop();
-        delete decoder;
-        decoder = new QAudioDecoder(this);
-        connect(decoder, &QAudioDecoder::bufferReady, this, [this]() {
-            QAudioBuffer buf = decoder->read(); processBuffer(buf);
-        });
-        connect(decoder, &QAudioDecoder::finished, this, &AudioEditor::decodingFinished);
-    }
     if (modeAutonome) {
         currentAudioFile = QFileDialog::getOpenFileName(this,
             tr("Ouvrir un fichier audio"), {}, tr("Audio (*.wav *.mp3 *.flac)"));
     }
     if (currentAudioFile.isEmpty()) return;
 
-    // player->setSource(QUrl::fromLocalFile(currentAudioFile));
-    audioSamples.clear(); 
+    // Un éventuel chargement précédent est abandonné, ses blocs en vol seront ignorés
+    loader->cancel();
+    const int loadId = ++currentLoadId;
+
+    playback->stop();
+    document->clear();
     totalSamples = 0;
+    history.clear();
+    waveformWidget->setPreviewPeaks(QVector<PeakPyramid>());
     waveformWidget->setLoading(true);
-    QCoreApplication::processEvents();
-    if (currentAudioFile.endsWith(".wav", Qt::CaseInsensitive))
-        extractWaveform(currentAudioFile);
-    else
-        extractWaveformWithFFmpeg(currentAudioFile);
+
+    const QString path = currentAudioFile;
+
+    // Fichier déjà ouvert auparavant : la forme d'onde complète s'affiche dès
+    // que le cache de pics est lu (hors du thread de l'interface, l'entrée peut
+    // peser des dizaines de Mo), le signal exact arrive ensuite en arrière-plan
+    auto *cacheWatcher = new QFutureWatcher<PeakCache::Entry>(this);
+    connect(cacheWatcher, &QFutureWatcher<PeakCache::Entry>::finished, this, [this, cacheWatcher, loadId]() {
+        const PeakCache::Entry cached = cacheWatcher->result();
+        cacheWatcher->deleteLater();
+        // Autre fichier ouvert entre-temps, ou décodage déjà terminé : l'aperçu est inutile
+        if (loadId != currentLoadId || !isDecoding || cached.peaks.isEmpty()) return;
+        sampleRate = cached.sampleRate;
+        waveformWidget->setPreviewPeaks(cached.peaks);
+        updateLengthLabel(cached.peaks[0].sampleCount());
+    });
+    cacheWatcher->setFuture(QtConcurrent::run([path]() {
+        PeakCache::Entry cached;
+        if (!PeakCache::load(path, cached)) cached.peaks.clear();
+        return cached;
+    }));
+
+    // WAV : la sauvegarde réécrira la résolution d'origine (16/24/32 bits, float)
+    sourceBitsPerSample = 0;
+    sourceFloat = false;
+    AudioProber::WavInfo wav;
+    if (path.endsWith(".wav", Qt::CaseInsensitive) && AudioProber::readWavInfo(path, wav)) {
+        quint16 tag = wav.formatTag;
+        if (tag == 0xFFFE && wav.fmtChunk.size() >= 26)
+            tag = qFromLittleEndian<quint16>(wav.fmtChunk.constData() + 24);   // Sous-format
+        if (tag == 1 && (wav.bitsPerSample == 16 || wav.bitsPerSample == 24 || wav.bitsPerSample == 32)) {
+            sourceBitsPerSample = wav.bitsPerSample;
+        } else if (tag == 3 && wav.bitsPerSample == 32) {
+            sourceBitsPerSample = 32;
+            sourceFloat = true;
+        }
+    }
+    if (path.endsWith(".wav", Qt::CaseInsensitive)) {
+        QMetaObject::invokeMethod(loader, [this, loadId, path]() {
+            loader->loadWithDecoder(loadId, path);
+        });
+    } else {
+        if (!checkFFmpegAvailability()) {
+            isDecoding = false;     // Le chargement précédent a été abandonné
+            waveformWidget->setLoading(false);
+            return;
+        }
+        const QString ffmpegPath = getFFmpegPath();
+        QMetaObject::invokeMethod(loader, [this, loadId, path, ffmpegPath]() {
+            loader->loadWithFFmpeg(loadId, path, ffmpegPath);
+        });
+    }
+    isDecoding = true;
     
     setWindowTitle(tr("Éditeur Audio - ") + QFileInfo(currentAudioFile).fileName());
     
+    // Lecture, zoom et sélection restent possibles sur la partie déjà décodée ;
+    // les modifications attendent la fin du chargement
     setButtonsEnabled(true);
+    ui->btnNormalizeAll->setEnabled(false);
+    ui->btnSave->setEnabled(false);
     waveformWidget->resetSelection(-1);
     waveformWidget->setPlayheadPosition(0);
     waveformWidget->setisLoaded(true);
-    player->setSource(QUrl::fromLocalFile(currentAudioFile));
-}
-
-void AudioEditor::extractWaveform(const QString &path)
-{
-    decoder->setSource(QUrl::fromLocalFile(path));
-    decoder->start();
 }
 
 // Ancienne méthode qui ne gere pas le mono/stéréo
@@ -306,42 +389,6 @@ void AudioEditor::extractWaveform(const QString &path)
 // }
 
 
-int AudioEditor::getChannelCount(const QString &filePath)
-{
-    QProcess process;
-    QString ffmpegPath = getFFmpegPath();
-    
-    // On lance juste "ffmpeg -i fichier"
-    // FFmpeg va afficher les infos et s'arrêter car il manque le fichier de sortie
-    QStringList args;
-    args << "-i" << filePath; 
-
-    process.start(ffmpegPath, args);
-    process.waitForFinished(3000); 
-
-    // FFmpeg écrit les infos techniques dans le canal d'Erreur (StandardError), pas Output !
-    QString output = process.readAllStandardError(); 
-
-    // On analyse le texte pour trouver "stereo" ou "mono"
-    // Ex de sortie : "Stream #0:0: Audio: mp3, 44100 Hz, stereo, fltp, 128 kb/s"
-    
-    if (output.contains(" stereo,", Qt::CaseInsensitive)) {
-        return 2;
-    }
-    
-    if (output.contains(" mono,", Qt::CaseInsensitive)) {
-        return 1;
-    }
-
-    // Sécurité pour les formats bizarres ("1 channels")
-    if (output.contains("1 channels", Qt::CaseInsensitive)) return 1;
-    if (output.contains("2 channels", Qt::CaseInsensitive)) return 2;
-
-    // Par défaut, si on ne sait pas, on dit 2 (Stéréo) 
-    // pour déclencher la formule de mixage sécurisée (0.5+0.5) et éviter la saturation.
-    return 2; 
-}
-
 // Extract ok mais pb gestion de la memoire avecc gros fichier
 // void AudioEditor::extractWaveformWithFFmpeg(const QString &path)
 // {
@@ -426,143 +473,96 @@ int AudioEditor::getChannelCount(const QString &filePath)
 //     QApplication::restoreOverrideCursor();
 // }
 
-void AudioEditor::extractWaveformWithFFmpeg(const QString &path)
+void AudioEditor::handleStreamInfo(int loadId, int rate, int channelCount, qint64 expectedSamples)
 {
-    if (!checkFFmpegAvailability()) {
-        QApplication::restoreOverrideCursor();
-        return;
+    if (loadId != currentLoadId) return;
+    if (rate > 0) sampleRate = rate;
+    // Canaux d'origine, gardés séparés (un couloir chacun dans la forme d'onde)
+    SampleBlock::Encoding encoding = SampleBlock::Encoding::Float32;
+    if (compactSamples && !sourceFloat) {
+        if (sourceBitsPerSample == 16) encoding = SampleBlock::Encoding::Int16;
+        else if (sourceBitsPerSample == 24) encoding = SampleBlock::Encoding::Int24;
     }
-    
-    // 1. Activation de l'interface de chargement
-    waveformWidget->setLoading(true);
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    QCoreApplication::processEvents(); 
+    document->setEncoding(encoding);
+    document->setChannelCount(channelCount);
 
-    QString tmp = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/temp.raw";
-    QString ffmpegPath = getFFmpegPath();
-    
-    int channels = getChannelCount(path);
-    
-    QStringList args;
-    args << "-y" << "-i" << path; // Ajout de -y pour forcer l'écrasement si le temp existe
-    if (channels > 1) {
-        args << "-af" << "pan=mono|c0=0.5*c0+0.5*c1";
-    } else {
-        args << "-ac" << "1"; 
-    }
-    
-    args << "-ar" << "44100"
-         << "-f" << "f32le"
-         << tmp;
+    // On connaît la longueur finale : la forme d'onde se remplit
+    // de gauche à droite sur toute la largeur
+    waveformWidget->setExpectedLength(expectedSamples);
+    if (expectedSamples > 0) updateLengthLabel(expectedSamples);
+}
+
+void AudioEditor::appendDecodedSamples(int loadId, const QVector<QVector<float>> &channels)
+{
+    if (loadId != currentLoadId) return;
 
-    QProcess ff;
-    ff.start(ffmpegPath, args);
-    
-    // 2. CORRECTION TIMEOUT : 15s est trop court pour 264Mo. 
-    // On passe à 300000ms (5 minutes) ou -1 (infini) pour être sûr.
-    if (!ff.waitForFinished(300000) || ff.exitStatus() != QProcess::NormalExit) {
-        waveformWidget->setLoading(false); 
-        QMessageBox::warning(this, tr("Erreur FFmpeg"),
-                             tr("La commande FFmpeg a échoué ou a pris trop de temps.\n%1").arg(QString(ff.readAllStandardError())));
-        QApplication::restoreOverrideCursor();
-        return;
-    }
-    
-    QFile f(tmp);
-    if (!f.open(QIODevice::ReadOnly)) {
-        waveformWidget->setLoading(false);
-        QMessageBox::warning(this, tr("Erreur"), tr("Impossible d'ouvrir le fichier raw généré."));
-        QApplication::restoreOverrideCursor();
-        return;
-    }
-    
-    // 3. CORRECTION MÉMOIRE (La partie critique)
-    qint64 fileSize = f.size();
-    qint64 samplesCount = fileSize / sizeof(float);
-
-    if (samplesCount <= 0) {
-        waveformWidget->setLoading(false);
-        QMessageBox::warning(this, tr("Erreur"), tr("Aucun échantillon n'a été extrait."));
-        f.close();
-        QApplication::restoreOverrideCursor();
-        return;
-    }
-    
-    // Au lieu de tout lire dans un QByteArray (double RAM),
-    // on redimensionne d'abord le vecteur cible...
     try {
-        audioSamples.resize(samplesCount);
+        document->append(channels);     // La forme d'onde suit l'ajout
     } catch (const std::bad_alloc&) {
-        waveformWidget->setLoading(false);
-        f.close();
-        QFile::remove(tmp);
-        QApplication::restoreOverrideCursor();
+        loader->cancel();
+        ++currentLoadId; // Les blocs déjà en file d'attente seront ignorés
+        isDecoding = false;
+        document->clear();
+        totalSamples = 0;
+        waveformWidget->finishLoading();
         QMessageBox::critical(this, tr("Erreur Mémoire"), 
             tr("Fichier trop volumineux pour la mémoire disponible (RAM insuffisante)."));
         return;
     }
 
-    // ... et on lit directement du disque vers le vecteur
-    // On lit par blocs pour ne pas geler l'OS si le disque est lent, 
-    // bien que read() direct soit possible.
-    char* ptr = reinterpret_cast<char*>(audioSamples.data());
-    qint64 bytesToRead = fileSize;
-    while (bytesToRead > 0) {
-        qint64 chunk = qMin(bytesToRead, qint64(1024 * 1024 * 64)); // Blocs de 64Mo
-        qint64 read = f.read(ptr, chunk);
-        if (read <= 0) break;
-        ptr += read;
-        bytesToRead -= read;
-    }
-
-    f.close(); 
-    QFile::remove(tmp);
-    
-    totalSamples = audioSamples.size();
-    
-    waveformWidget->setLoading(false); 
-    waveformWidget->setFullWaveform(audioSamples);
-    
-    QApplication::restoreOverrideCursor();
+    totalSamples = document->size();
+    // La lecture peut suivre ce qui est déjà décodé
+    playback->setSamples(document->samples(), sampleRate);
 }
 
-void AudioEditor::processBuffer(const QAudioBuffer &buf)
+void AudioEditor::decodingFinished(int loadId, bool success, const QString &errorMessage)
 {
-    int frames = buf.frameCount(); if (frames <= 0) return;
-    auto fmt = buf.format(); int ch = fmt.channelCount(), bps = fmt.bytesPerSample();
-    const char *raw = buf.constData<char>();
-    for (int i = 0; i < frames; ++i) {
-        double s = 0;
-        if (bps == 2) {
-            auto *d = reinterpret_cast<const qint16*>(raw);
-            for (int c = 0; c < ch; ++c)
-                s += d[i*ch + c] / 32768.0;
-        } else {
-            auto *d = reinterpret_cast<const qint32*>(raw);
-            for (int c = 0; c < ch; ++c)
-                s += d[i*ch + c] / 2147483648.0;
-        }
-        audioSamples.append(s / ch);
-    }
-    totalSamples += frames;
-}
+    if (loadId != currentLoadId) return;
 
-void AudioEditor::decodingFinished()
-{
-    if (audioSamples.isEmpty()) {
+    isDecoding = false;
+    totalSamples = document->size();
+    waveformWidget->finishLoading();
+    playback->setSamples(document->samples(), sampleRate);
+    updateLengthLabel(totalSamples);
+
+    if (!success) {
+        if (!errorMessage.isEmpty())
+            QMessageBox::warning(this, tr("Erreur"), errorMessage);
+        return;
+    }
+    if (document->isEmpty()) {
         QMessageBox::warning(this, tr("Erreur"), tr("Aucun échantillon lu."));
         return;
     }
-    totalSamples = audioSamples.size();
-    waveformWidget->setLoading(false);
-    waveformWidget->setFullWaveform(audioSamples);
+
+    // Pics mis en cache pour la prochaine ouverture du même fichier
+    if (!isTempRecording) {
+        PeakCache::Entry entry;
+        entry.sampleRate = sampleRate;
+        entry.peaks = waveformWidget->peakPyramids();
+        // Écriture en arrière-plan : les pyramides sont partagées (copie implicite)
+        const QString path = currentAudioFile;
+        if (!entry.peaks.isEmpty())
+            QThreadPool::globalInstance()->start([path, entry]() { PeakCache::save(path, entry); });
+    }
+
+    // Les actions qui modifient le signal n'étaient pas disponibles pendant le chargement
+    ui->btnSave->setEnabled(true);
+    updateUndoButtons();
+    if (waveformWidget->hasSelection()) {
+        ui->btnCut->setEnabled(true);
+        ui->btnNormalize->setEnabled(true);
+    } else if (playback->state() != AudioPlayback::PlayingState) {
+        ui->btnNormalizeAll->setEnabled(true);
+    }
 }
 
-std::pair<int,int> AudioEditor::getSelectionSampleRange()
+std::pair<qint64, qint64> AudioEditor::getSelectionSampleRange()
 {
-    int s = waveformWidget->getSelectionStart();
-    int e = waveformWidget->getSelectionEnd();
-    return { qBound(0, s, totalSamples), qBound(0, e, totalSamples) };
+    // Positions sur 64 bits : un enregistrement de plusieurs jours dépasse 2^31 échantillons
+    qint64 s = waveformWidget->getSelectionStart();
+    qint64 e = waveformWidget->getSelectionEnd();
+    return { qBound<qint64>(0, s, totalSamples), qBound<qint64>(0, e, totalSamples) };
 }
 
 void AudioEditor::cutSelection()
@@ -572,41 +572,43 @@ void AudioEditor::cutSelection()
         return;
     }
     QApplication::setOverrideCursor(Qt::WaitCursor);
-    double oldZoom = waveformWidget->getSamplesPerPixel();
-    int oldScroll = waveformWidget->getScrollOffset();
 
-    int safeSize = audioSamples.size();
+    qint64 safeSize = document->size();
     auto range = getSelectionSampleRange();
     
-    int s = std::clamp(range.first, 0, safeSize);
-    int e = std::clamp(range.second, 0, safeSize);
+    qint64 s = std::clamp<qint64>(range.first, 0, safeSize);
+    qint64 e = std::clamp<qint64>(range.second, 0, safeSize);
 
-    if (s >= e) return;
+    if (s >= e) {
+        QApplication::restoreOverrideCursor();
+        return;
+    }
 
-    player->stop();
+    playback->stop();
 
-    int countToRemove = e - s;
+    qint64 countToRemove = e - s;
     
     if (s + countToRemove > safeSize) {
         countToRemove = safeSize - s;
     }
 
     if (countToRemove > 0) {
-        audioSamples.remove(s, countToRemove);
+        EditHistory::State before = captureState(tr("Couper"));
+        document->remove(s, countToRemove);    // La forme d'onde ne refait que la fin
+        history.push(before, document->samples());
         isModified = true;
+        ++editCounter;
     }
     
-    totalSamples = audioSamples.size();
-
-    waveformWidget->setFullWaveform(audioSamples);
-    waveformWidget->restoreZoomState(oldZoom, oldScroll);
+    totalSamples = document->size();
     
-    int newPos = std::clamp(s, 0, (int)audioSamples.size());
+    qint64 newPos = std::clamp<qint64>(s, 0, totalSamples);
     waveformWidget->resetSelection(newPos);
     waveformWidget->setPlayheadPosition(newPos);
 
     ui->btnCut->setEnabled(false);
     ui->btnNormalize->setEnabled(false);
+    updateUndoButtons();
     
     updatePlaybackFromModifiedData();
     QApplication::restoreOverrideCursor();    
@@ -614,32 +616,38 @@ void AudioEditor::cutSelection()
 
 void AudioEditor::normalizeSelection()
 {
-    int startIndex,endIndex;
+    qint64 startIndex, endIndex;
     if (!waveformWidget->hasSelection()) {
         startIndex = 0;
-        endIndex = audioSamples.size();
+        endIndex = document->size();
     }
     else
     {
         std::tie(startIndex, endIndex) = getSelectionSampleRange();
     }
     if (startIndex >= endIndex) return;
-    double oldZoom   = waveformWidget->getSamplesPerPixel();
-    int    oldScroll = waveformWidget->getScrollOffset();
     QApplication::setOverrideCursor(Qt::WaitCursor);
     
-    player->stop();
-    float mv = 0.0f;
-    for (int i = startIndex; i < endIndex; ++i)
-        mv = qMax(mv, std::fabs(audioSamples[i]));
-    if (mv <= 0.0f) return;
+    playback->stop();
+    float mv = document->samples().absMax(startIndex, endIndex);
+    if (mv <= 0.0f) {
+        QApplication::restoreOverrideCursor();
+        return;
+    }
     float scale = 1.0f / mv;
-    for (int i = startIndex; i < endIndex; ++i)
-        audioSamples[i] *= scale;
+    // Seule la plage est recopiée dans de nouveaux blocs ; les anciens restent
+    // référencés par l'historique pour pouvoir annuler
+    EditHistory::State before = captureState(tr("Normaliser"));
+    if (!document->applyGain(startIndex, endIndex, scale)) {
+        QApplication::restoreOverrideCursor();
+        QMessageBox::critical(this, tr("Erreur"),
+            tr("Impossible de lire ou d'écrire les échantillons (fichier d'échange inaccessible et mémoire insuffisante)."));
+        return;
+    }
+    history.push(before, document->samples());
     isModified = true;
-
-    waveformWidget->setFullWaveform(audioSamples);
-    waveformWidget->restoreZoomState(oldZoom, oldScroll);
+    ++editCounter;
+    updateUndoButtons();
 
     waveformWidget->setStartAndEnd(startIndex, endIndex);
     waveformWidget->setPlayheadPosition(startIndex);
@@ -648,19 +656,76 @@ void AudioEditor::normalizeSelection()
     QApplication::restoreOverrideCursor();
 }
 
-void AudioEditor::updatePlaybackFromModifiedData()
+// ============================================================================
+// ANNULER / RÉTABLIR
+// ============================================================================
+
+EditHistory::State AudioEditor::captureState(const QString &label) const
 {
-    QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-    static int playbackCounter = 0;
-    QString tempPlaybackFile = tempDir + QString("/temp_playback_%1.wav").arg(++playbackCounter);
+    EditHistory::State state;
+    state.samples = document->samples();  // Copie de la liste des morceaux seulement
+    state.selectionStart = waveformWidget->getSelectionStart();
+    state.selectionEnd = waveformWidget->getSelectionEnd();
+    state.label = label;
+    return state;
+}
 
-    if (!writeWavFromFloatBuffer(tempPlaybackFile)) {
-        QMessageBox::warning(this, tr("Erreur"), tr("Impossible de générer le fichier WAV temporaire."));
-        return;
+void AudioEditor::restoreState(const EditHistory::State &state)
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    playback->stop();
+    // Seule la plage qui diffère de l'état courant est redessinée
+    document->replace(state.samples);
+    totalSamples = document->size();
+    isModified = true;
+    ++editCounter;
+
+    if (state.selectionEnd > state.selectionStart && state.selectionStart >= 0) {
+        waveformWidget->setStartAndEnd(state.selectionStart, state.selectionEnd);
+    } else {
+        qint64 pos = std::clamp<qint64>(state.selectionStart, 0, totalSamples);
+        waveformWidget->resetSelection(pos);
+        waveformWidget->setPlayheadPosition(pos);
     }
+    handleSelectionChanged(waveformWidget->getSelectionStart(), waveformWidget->getSelectionEnd());
+    updateUndoButtons();
+
+    updatePlaybackFromModifiedData();
+    QApplication::restoreOverrideCursor();
+}
 
-    player->stop();
-    player->setSource(QUrl::fromLocalFile(tempPlaybackFile));
+void AudioEditor::undo()
+{
+    if (isDecoding || !history.canUndo()) return;
+    restoreState(history.undo(captureState(history.undoLabel())));
+}
+
+void AudioEditor::redo()
+{
+    if (isDecoding || !history.canRedo()) return;
+    restoreState(history.redo(captureState(history.redoLabel())));
+}
+
+void AudioEditor::updateUndoButtons()
+{
+    ui->btnUndo->setEnabled(!isDecoding && history.canUndo());
+    ui->btnRedo->setEnabled(!isDecoding && history.canRedo());
+    ui->btnUndo->setToolTip(history.canUndo() ? tr("Annuler : %1").arg(history.undoLabel()) : tr("Annuler"));
+    ui->btnRedo->setToolTip(history.canRedo() ? tr("Rétablir : %1").arg(history.redoLabel()) : tr("Rétablir"));
+}
+
+void AudioEditor::updatePlaybackFromModifiedData()
+{
+    // Le lecteur reçoit la nouvelle liste de morceaux : ni fichier ni copie
+    playback->stop();
+    playback->setSamples(document->samples(), sampleRate);
+    updateLengthLabel(totalSamples);
+}
+
+void AudioEditor::updateLengthLabel(qint64 samples)
+{
+    ui->lengthLabel->setText(timeToPosition(samples, "hh:mm:ss"));
 }
 
 // void AudioEditor::saveModifiedAudio()
@@ -791,7 +856,8 @@ void AudioEditor::updatePlaybackFromModifiedData()
 
 void AudioEditor::saveModifiedAudio()
 {
-    if (audioSamples.isEmpty()) {
+    if (saveJob) return;    // Une sauvegarde est déjà en cours
+    if (document->isEmpty()) {
         QMessageBox::warning(this, tr("Erreur"), tr("Aucun signal audio à sauvegarder."));
         return;
     }
@@ -799,9 +865,7 @@ void AudioEditor::saveModifiedAudio()
     // ========================================================================
     // CORRECTION 1 : LIBÉRATION TOTALE DU FICHIER
     // ========================================================================
-    player->stop();
-    player->setSource(QUrl()); // Détache le fichier du lecteur
-    if (decoder) decoder->stop(); // Par sécurité
+    playback->stop();   // La lecture se fait depuis la mémoire : le fichier n'est pas verrouillé
 
     // ========================================================================
     // CORRECTION 2 : ANTI-SATURATION (AUTO-LIMITER)
@@ -843,18 +907,12 @@ void AudioEditor::saveModifiedAudio()
         dialog.resize(280, dialog.height());
         bool ok = (dialog.exec() == QDialog::Accepted);
         QString fileName = lineEdit->text();
-        if (!ok || fileName.isEmpty()) {
-            // Si annulation, on recharge le son pour ne pas planter
-             player->setSource(QUrl::fromLocalFile(currentAudioFile));
-             return;
-        }
+        if (!ok || fileName.isEmpty()) return;
         if (!fileName.endsWith(".wav", Qt::CaseInsensitive)) fileName += ".wav";
         targetFile = QDir(workingDirectory).filePath(fileName);
         if (QFile::exists(targetFile)) {
-             if (QMessageBox::question(this, tr("Existe"), tr("Écraser ?"), QMessageBox::Yes|QMessageBox::No) != QMessageBox::Yes) {
-                 player->setSource(QUrl::fromLocalFile(currentAudioFile));
+             if (QMessageBox::question(this, tr("Existe"), tr("Écraser ?"), QMessageBox::Yes|QMessageBox::No) != QMessageBox::Yes)
                  return;
-             }
         }
     } else {
         targetFile = currentAudioFile;
@@ -878,182 +936,133 @@ void AudioEditor::saveModifiedAudio()
         if (reply != QMessageBox::Yes) return;
     }
     
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    QString tempWav = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/temp_save.wav";
+    startSave(targetFile);
+}
 
-    // Écriture du fichier temporaire
-    if (!writeWavFromFloatBuffer(tempWav)) {
-        QMessageBox::warning(this, tr("Erreur"), tr("Impossible d'écrire le WAV temporaire."));
-        QApplication::restoreOverrideCursor();
-        player->setSource(QUrl::fromLocalFile(currentAudioFile));
-        return;
-    }
+void AudioEditor::startSave(const QString &targetFile)
+{
+    SaveJob::Request request;
+    request.samples = document->samples();  // Instantané : liste des morceaux seulement
+    request.format = wavFormat();
+    request.targetFile = targetFile;
+    request.ffmpegPath = getFFmpegPath();
+
+    savingTarget = targetFile;
+    savingEditCounter = editCounter;
+
+    saveJob = new SaveJob(request);
+    saveJob->moveToThread(&saveThread);
+    connect(saveJob, &SaveJob::progress, this, &AudioEditor::handleSaveProgress);
+    connect(saveJob, &SaveJob::finished, this, &AudioEditor::handleSaveFinished);
+    if (!saveThread.isRunning()) saveThread.start();
+
+    // Fenêtre non modale : l'édition et la lecture restent possibles
+    saveProgress = new QProgressDialog(tr("Sauvegarde en cours..."), tr("Annuler"), 0, 1000, this);
+    saveProgress->setWindowTitle(tr("Sauvegarde"));
+    saveProgress->setWindowModality(Qt::NonModal);
+    saveProgress->setMinimumDuration(500);
+    saveProgress->setAutoClose(false);
+    saveProgress->setAutoReset(false);
+    saveProgress->setValue(0);
+    SaveJob *job = saveJob;
+    connect(saveProgress, &QProgressDialog::canceled, this, [this, job]() {
+        job->cancel();
+        saveProgress->setLabelText(tr("Annulation..."));
+    });
 
-    bool success = false;
+    ui->btnSave->setEnabled(false);
+    QMetaObject::invokeMethod(saveJob, "run", Qt::QueuedConnection);
+}
 
-    // ========================================================================
-    // CORRECTION 3 : BOUCLE DE RÉESSAI POUR LE FICHIER VERROUILLÉ (WAV)
-    // ========================================================================
-    if (targetFile.endsWith(".wav", Qt::CaseInsensitive)) {
-        
-        // Si le fichier existe, on essaie de le supprimer avec insistance
-        if (QFile::exists(targetFile)) {
-            bool removed = false;
-            // On essaie 10 fois avec 100ms de pause (1 seconde max)
-            for (int i = 0; i < 10; ++i) {
-                if (QFile::remove(targetFile)) {
-                    removed = true;
-                    break;
-                }
-                QThread::msleep(100); // Pause pour laisser Windows libérer le fichier
-            }
+void AudioEditor::handleSaveProgress(double fraction, const QString &stage)
+{
+    if (!saveProgress || saveProgress->wasCanceled()) return;
+    saveProgress->setLabelText(stage);
+    saveProgress->setValue(int(fraction * 1000));
+}
 
-            if (!removed) {
-                QMessageBox::warning(this, tr("Erreur"), 
-                    tr("Impossible d'écraser le fichier.\nIl est peut-être utilisé par une autre application ou l'antivirus."));
-                QFile::remove(tempWav);
-                QApplication::restoreOverrideCursor();
-                player->setSource(QUrl::fromLocalFile(currentAudioFile)); // On rétablit
-                return;
-            }
-        }
-        
-        // Copie du nouveau fichier
-        if (QFile::copy(tempWav, targetFile)) {
-            success = true;
-        } else {
-            QMessageBox::warning(this, tr("Erreur"), tr("Impossible de copier le fichier final."));
-        }
-        QFile::remove(tempWav);
-    } 
-    else {
-        // ====================================================================
-        // GESTION MP3 / AUTRES (Conversion FFmpeg)
-        // ====================================================================
-        // Pour le MP3, comme on a déjà appliqué l'Auto-Limiter au début,
-        // le son envoyé à FFmpeg est propre et ne saturera pas.
-        
-        QString ffmpegPath = getFFmpegPath();
-        QStringList args;
-        args << "-y" << "-i" << tempWav;
-        
-        if (targetFile.endsWith(".mp3", Qt::CaseInsensitive)) {
-            args << "-codec:a" << "libmp3lame" << "-q:a" << "2"; 
-        } else if (targetFile.endsWith(".m4a", Qt::CaseInsensitive)) {
-            args << "-codec:a" << "aac" << "-b:a" << "192k";
-        }
-        
-        args << targetFile;
-        QProcess ff;
-        ff.start(ffmpegPath, args);
-        
-        if (ff.waitForFinished(30000) && ff.exitStatus() == QProcess::NormalExit) {
-            success = true;
-        } else {
-            QString err = ff.readAllStandardError();
-            QMessageBox::warning(this, tr("Erreur FFmpeg"), tr("Échec encodage: %1").arg(err));
-        }
-        QFile::remove(tempWav);
+void AudioEditor::handleSaveFinished(bool success, const QString &errorMessage)
+{
+    if (saveJob) {
+        saveJob->deleteLater();
+        saveJob = nullptr;
     }
+    if (saveProgress) {
+        saveProgress->deleteLater();
+        saveProgress = nullptr;
+    }
+    ui->btnSave->setEnabled(true);
 
-    QApplication::restoreOverrideCursor();
-
-    if (success) {
-        isModified = false;
-        if (isTempRecording) isTempRecording = false;
-        currentAudioFile = targetFile;
-        setWindowTitle(tr("Éditeur Audio - ") + QFileInfo(currentAudioFile).fileName());
-        QMessageBox::information(this, tr("Succès"), tr("Fichier sauvegardé avec succès."));
+    if (!success) {
+        closeAfterSave = false;
+        if (!errorMessage.isEmpty())
+            QMessageBox::warning(this, tr("Erreur"), errorMessage);
+        return;
     }
-    
-    // IMPORTANT : On recharge le fichier frais
-    player->setSource(QUrl::fromLocalFile(currentAudioFile));
-}
 
-void AudioEditor::updatePlayhead(qint64 ms)
-{
-    qint64 dur = player->duration();
-    if (dur <= 0) return;
-    qint64 idx = static_cast<qint64>((double)ms / dur * totalSamples);
-    if (waveformWidget->hasSelection() && idx >= waveformWidget->getSelectionEnd()) {
-        stopPlayback();
+    // Des modifications faites pendant la sauvegarde restent à enregistrer
+    isModified = (editCounter != savingEditCounter);
+    if (isTempRecording) isTempRecording = false;
+    currentAudioFile = savingTarget;
+    setWindowTitle(tr("Éditeur Audio - ") + QFileInfo(currentAudioFile).fileName());
+
+    if (closeAfterSave) {
+        closeAfterSave = false;
+        close();
         return;
     }
+    QMessageBox::information(this, tr("Succès"), tr("Fichier sauvegardé avec succès."));
+}
 
+void AudioEditor::updatePlayhead(qint64 idx)
+{
+    // idx vient de l'horloge de la sortie audio ; l'arrêt en fin de sélection
+    // est fait par le lecteur lui-même, au sample près
     waveformWidget->setPlayheadPosition(idx);
-    updatePositionLabel(ms);
+    ui->positionLabel->setText(timeToPosition(idx, "hh:mm:ss"));
 
-    int visibleStart = waveformWidget->getScrollOffset();
-    int visibleEnd   = visibleStart + waveformWidget->width();
-    int playheadPixel = waveformWidget->sampleToPixel(idx);
+    qint64 visibleStart = waveformWidget->getScrollOffset();
+    qint64 visibleEnd   = visibleStart + waveformWidget->width();
+    qint64 playheadPixel = waveformWidget->sampleToPixel(idx);
     if (playheadPixel < visibleStart || playheadPixel > visibleEnd - 30) {
         waveformWidget->scrollToPixel(playheadPixel - waveformWidget->width() / 3);
     }
 }
 
-bool AudioEditor::writeWavFromFloatBuffer(const QString &filename)
+WavWriter::Format AudioEditor::wavFormat() const
 {
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly)) return false;
-
-    const int sampleRate = 44100;
-    const int channels = 1;
-    const int bitsPerSample = 16;
-    const int byteRate = sampleRate * channels * bitsPerSample / 8;
-    const int blockAlign = channels * bitsPerSample / 8;
-    int dataSize = static_cast<int>(audioSamples.size() * sizeof(qint16));
-    const int fileSize = 44 + dataSize - 8;
-
-    QDataStream out(&file);
-    out.setByteOrder(QDataStream::LittleEndian);
-
-    out.writeRawData("RIFF", 4);
-    out << quint32(fileSize);
-    out.writeRawData("WAVE", 4);
-
-    out.writeRawData("fmt ", 4);
-    out << quint32(16);
-    out << quint16(1);
-    out << quint16(channels);
-    out << quint32(sampleRate);
-    out << quint32(byteRate);
-    out << quint16(blockAlign);
-    out << quint16(bitsPerSample);
-
-    out.writeRawData("data", 4);
-    out << quint32(dataSize);
-
-    for (const float &sample : audioSamples) { 
-        qint16 val = qBound(static_cast<qint16>(-32768),
-                            static_cast<qint16>(sample * 32767),
-                            static_cast<qint16>(32767));
-        out << val;
+    // Résolution et dither réglables dans la configuration (16 bits sans dither par défaut)
+    QSettings settings;
+    WavWriter::Format format;
+    format.sampleRate = sampleRate;
+    format.bitsPerSample = settings.value("editor/wavBitsPerSample", 16).toInt();
+    format.dither = settings.value("editor/wavDither", false).toBool();
+    // Fichier WAV d'origine : même résolution, pas de requantification
+    if (sourceBitsPerSample > 0) {
+        format.bitsPerSample = sourceBitsPerSample;
+        format.floatSamples = sourceFloat;
     }
-
-    file.close();
-    return true;
+    return format;
 }
 
 void AudioEditor::playPause()
 {
-    if (player->playbackState() == QMediaPlayer::PlayingState) {
+    if (playback->state() == AudioPlayback::PlayingState) {
         ui->btnPlay->setIcon(QIcon(":/icones/play.png"));
-        player->pause();
+        playback->pause();
     } else {
         ui->btnPlay->setIcon(QIcon(":/icones/pause.png"));
 
-        if (player->playbackState() == QMediaPlayer::StoppedState) {
+        if (playback->state() == AudioPlayback::PausedState) {
+            playback->resume();
+        } else {
             qint64 s = waveformWidget->getSelectionStart();
             if (s < 0) {
                 s = waveformWidget->getPlayheadPosition();
-            }            
-            if (s >= 0 && totalSamples > 0 && player->duration() > 0) {
-                qint64 posMs = static_cast<qint64>((double)s / totalSamples * player->duration());
-                player->setPosition(posMs);
             }
+            const qint64 e = waveformWidget->hasSelection() ? waveformWidget->getSelectionEnd() : -1;
+            playback->play(std::max<qint64>(0, s), e);
         }
-        
-        player->play();
     }
 
     ui->btnStop->setEnabled(true);
@@ -1062,12 +1071,10 @@ void AudioEditor::playPause()
 
 void AudioEditor::stopPlayback()
 {
-    player->blockSignals(true);
-    player->stop();
-    player->blockSignals(false);
+    playback->stop();
 
     ui->btnStop->setEnabled(false);
-    if (!waveformWidget->hasSelection()) ui->btnNormalizeAll->setEnabled(true);
+    if (!waveformWidget->hasSelection() && !isDecoding) ui->btnNormalizeAll->setEnabled(true);
     ui->btnPlay->setIcon(QIcon(":/icones/play.png"));
 
     const qint64 startposition = waveformWidget->getSelectionStart();
@@ -1098,41 +1105,45 @@ void AudioEditor::handleSelectionChanged(qint64 s, qint64 e)
             .arg(timeToPosition(s, "hh:mm:ss.zzz"))
             .arg(timeToPosition(e, "hh:mm:ss.zzz"))
             .arg(timeToPosition(e - s, "hh:mm:ss.zzz")));
-        ui->btnCut->setEnabled(true);
-        ui->btnNormalize->setEnabled(true);
+        ui->btnCut->setEnabled(!isDecoding);
+        ui->btnNormalize->setEnabled(!isDecoding);
         ui->btnNormalizeAll->setEnabled(false);
     } else {
         ui->selectionLabel->clear();
         ui->btnCut->setEnabled(false);
         ui->btnNormalize->setEnabled(false);
-        ui->btnNormalizeAll->setEnabled(true);
+        ui->btnNormalizeAll->setEnabled(!isDecoding);
     }
     ui->positionLabel->setText(timeToPosition(s,"hh:mm:ss"));
 }
 
-void AudioEditor::handleMediaStatusChanged(QMediaPlayer::MediaStatus status)
+void AudioEditor::handlePlaybackFinished()
 {
-    if (status == QMediaPlayer::EndOfMedia) {
-        qint64 pos = waveformWidget->hasSelection() ? waveformWidget->getSelectionStart() : 0;
-        waveformWidget->setPlayheadPosition(pos);
-        ui->btnPlay->setIcon(QIcon(":/icones/play.png"));
-        ui->btnStop->setEnabled(false);
-    }
+    qint64 pos = waveformWidget->hasSelection() ? waveformWidget->getSelectionStart() : 0;
+    waveformWidget->setPlayheadPosition(pos);
+    ui->btnPlay->setIcon(QIcon(":/icones/play.png"));
+    ui->btnStop->setEnabled(false);
+    if (!waveformWidget->hasSelection() && !isDecoding) ui->btnNormalizeAll->setEnabled(true);
 }
 
 void AudioEditor::releaseResources()
 {
-    if (player) {
-        player->stop();
-        player->setSource(QUrl()); 
+    if (playback) {
+        playback->stop();
     }
-    if (decoder) {
-        decoder->stop();
+    if (loader) {
+        loader->cancel();
     }
 }
 
 void AudioEditor::closeEvent(QCloseEvent *event)
 {
+    if (saveJob) {
+        // On ferme dès que la sauvegarde en cours a abouti
+        closeAfterSave = true;
+        event->ignore();
+        return;
+    }
     if (isModified) {
         QMessageBox msgBox(this);
         msgBox.setWindowTitle(tr("Modifications non enregistrées"));
@@ -1147,11 +1158,11 @@ void AudioEditor::closeEvent(QCloseEvent *event)
         msgBox.exec();
 
         if (msgBox.clickedButton() == btnOui) {
+            // La fenêtre se fermera à la fin de la sauvegarde, si elle réussit
             saveModifiedAudio();
-            if (isModified) {
-                event->ignore();
-                return;
-            }
+            if (saveJob) closeAfterSave = true;
+            event->ignore();
+            return;
         } else if (msgBox.clickedButton() == btnAnnuler) {
             event->ignore();
             return;
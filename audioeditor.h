@@ -1,14 +1,19 @@
 #pragma once
 
-#include <QMediaPlayer>
-#include <QAudioDecoder>
-#include <QAudioOutput>
+#include <QThread>
 #include <QCoreApplication>
 #include "waveformwidget.h"
+#include "audioloader.h"
+#include "audioplayback.h"
+#include "edithistory.h"
+#include "wavwriter.h"
 #include <QLabel>
 #include <QWidget>
 #include <QCloseEvent>
 
+class QProgressDialog;
+class SaveJob;
+
 
 namespace Ui {
     class AudioEditorWidget;
@@ -41,15 +46,20 @@ private slots:
     void playPause();
     void resetPosition();
     void stopPlayback();
-    void updatePlayhead(qint64 position);
-    void handleMediaStatusChanged(QMediaPlayer::MediaStatus status);
+    void updatePlayhead(qint64 sampleIndex);
+    void handlePlaybackFinished();
     void handleSelectionChanged(qint64 start, qint64 end);
     void handleZoomChanged(const QString &zoomFactor);
-    void processBuffer(const QAudioBuffer &buffer);
-    void decodingFinished();
+    void handleStreamInfo(int loadId, int sampleRate, int channelCount, qint64 expectedSamples);
+    void appendDecodedSamples(int loadId, const QVector<QVector<float>> &channels);
+    void decodingFinished(int loadId, bool success, const QString &errorMessage);
     void cutSelection();
     void saveModifiedAudio();
     void normalizeSelection();
+    void undo();
+    void redo();
+    void handleSaveProgress(double fraction, const QString &stage);
+    void handleSaveFinished(bool success, const QString &errorMessage);
 
 protected:
     void showEvent(QShowEvent *event) override;
@@ -76,27 +86,47 @@ private:
     // MÉTHODES EXISTANTES
     // ========================================================================
     
-    bool writeWavFromFloatBuffer(const QString &filename);
+    WavWriter::Format wavFormat() const;
     void init();
     Ui::AudioEditorWidget *ui;
-    QMediaPlayer   *player;
-    QAudioOutput   *audioOutput;
-    QAudioDecoder  *decoder;
+    AudioPlayback  *playback;       // Lecture directe depuis une copie du document
+    AudioLoader    *loader;
+    QThread         loaderThread;   // Le décodage tourne hors du thread graphique
+    int             currentLoadId = 0;
+    bool            isDecoding = false;
+    int             sampleRate = 44100;     // Fréquence d'origine du fichier
+    int             sourceBitsPerSample = 0; // WAV d'origine : résolution réécrite à la sauvegarde
+    bool            sourceFloat = false;
+    bool            compactSamples = true;   // Blocs 16/24 bits pour les WAV de cette résolution
     WaveformWidget *waveformWidget;
-    QVector<float>  audioSamples;
+    SampleDocument *document;       // Signal édité (un SampleBuffer par canal), partagé avec la forme d'onde
     qint64          totalSamples;
     QString         currentAudioFile;
     bool            modeAutonome;   
-    void extractWaveform(const QString &filePath);
-    void extractWaveformWithFFmpeg(const QString &filePath);
     QVector<float> downsampleBuffer(const QVector<float> &buffer, int targetSampleCount);
     void updatePlaybackFromModifiedData();
+    void updateLengthLabel(qint64 samples);
+
+    EditHistory     history;        // Annuler / rétablir sur blocs partagés
+    EditHistory::State captureState(const QString &label) const;
+    void restoreState(const EditHistory::State &state);
+    void updateUndoButtons();
 
-    std::pair<int, int> getSelectionSampleRange();
+    std::pair<qint64, qint64> getSelectionSampleRange();
     void setButtonsEnabled(bool enabled);
     bool fichierCharge = false;
     bool isModified; 
+
+    // Sauvegarde en arrière-plan, sur une copie du signal : on peut continuer
+    // à éditer ; editCounter dit si le fichier écrit est encore à jour
+    QThread          saveThread;
+    SaveJob         *saveJob = nullptr;
+    QProgressDialog *saveProgress = nullptr;
+    QString          savingTarget;
+    quint64          editCounter = 0;
+    quint64          savingEditCounter = 0;
+    bool             closeAfterSave = false;
+    void startSave(const QString &targetFile);
     void releaseResources();
     QString workingDirectory;
-    int getChannelCount(const QString &filePath);
 };
\ No newline at end of file
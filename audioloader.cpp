@@ -0,0 +1,267 @@
+#include "audioloader.h"
+#include "audioprober.h"
+#include "dspkernels.h"
+
+#include <QAudioDecoder>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QUrl>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+// Taille maximale d'un bloc envoyé à l'interface (~24 s à 44,1 kHz)
+static const qsizetype MAX_PENDING_SAMPLES = 1 << 20;
+// Intervalle minimal entre deux envois, pour ne pas saturer la boucle graphique
+static const qint64 EMIT_INTERVAL_MS = 100;
+
+AudioLoader::AudioLoader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void AudioLoader::cancel()
+{
+    cancelRequested = true;
+}
+
+void AudioLoader::stopDecoder()
+{
+    if (!decoder) return;
+    decoder->disconnect(this);
+    decoder->stop();
+    decoder->deleteLater();
+    decoder = nullptr;
+}
+
+void AudioLoader::flushPending(bool force)
+{
+    if (pending.isEmpty() || pending[0].isEmpty()) return;
+    if (!force && pending[0].size() < MAX_PENDING_SAMPLES && lastEmit.elapsed() < EMIT_INTERVAL_MS)
+        return;
+
+    emit samplesDecoded(currentLoadId, pending);
+    for (QVector<float> &channel : pending)
+        channel = QVector<float>();
+    lastEmit.restart();
+}
+
+bool AudioLoader::appendInterleaved(const void *frames, QAudioFormat::SampleFormat format,
+                                    qsizetype count, int channels)
+{
+    if (pending.size() != channels) pending.resize(channels);
+
+    // Un bloc neuf réserve d'emblée la taille qu'il aura probablement à l'envoi
+    // (limitée par ce qu'il reste à décoder) : plus de réallocation par tampon
+    qsizetype reserve = MAX_PENDING_SAMPLES;
+    if (expectedFrames > 0)
+        reserve = qsizetype(std::clamp<qint64>(expectedFrames - deliveredFrames, 0, MAX_PENDING_SAMPLES));
+    reserve = std::max(reserve, count);
+
+    QVarLengthArray<float *, 8> dst(channels);
+    for (int c = 0; c < channels; ++c) {
+        QVector<float> &out = pending[c];
+        if (out.isEmpty()) out.reserve(reserve);
+        const qsizetype oldSize = out.size();
+        out.resize(oldSize + count);
+        dst[c] = out.data() + oldSize;
+    }
+
+    // Le format est choisi une fois par tampon, jamais dans la boucle interne
+    switch (format) {
+    case QAudioFormat::Float:
+        DspKernels::deinterleave(static_cast<const float *>(frames), channels, count, dst.data());
+        break;
+    case QAudioFormat::Int16:
+        DspKernels::deinterleave(static_cast<const qint16 *>(frames), channels, count, dst.data());
+        break;
+    case QAudioFormat::Int32:
+        DspKernels::deinterleave(static_cast<const qint32 *>(frames), channels, count, dst.data());
+        break;
+    case QAudioFormat::UInt8:
+        DspKernels::deinterleave(static_cast<const quint8 *>(frames), channels, count, dst.data());
+        break;
+    default:
+        for (QVector<float> &out : pending)
+            out.resize(out.size() - count);
+        return false;
+    }
+    deliveredFrames += count;
+    return true;
+}
+
+// ============================================================================
+// CHARGEMENT VIA FFMPEG (MP3, M4A, ...)
+// ============================================================================
+
+void AudioLoader::loadWithFFmpeg(int loadId, const QString &filePath, const QString &ffmpegPath)
+{
+    stopDecoder();
+    cancelRequested = false;
+    currentLoadId = loadId;
+    infoSent = false;
+    pending.clear();
+    expectedFrames = 0;
+    deliveredFrames = 0;
+
+    // Fréquence et canaux d'origine : ni rééchantillonnage ni mixage.
+    // Si l'analyse échoue, on retombe sur du stéréo 44,1 kHz.
+    const AudioProber::Info probe = AudioProber::probe(filePath, ffmpegPath);
+    const int channels = probe.channels > 0 ? probe.channels : 2;
+    const int sampleRate = probe.sampleRate > 0 ? probe.sampleRate : 44100;
+
+    // FFmpeg écrit directement le f32le entrelacé sur sa sortie standard (pipe:1)
+    QStringList args;
+    args << "-hide_banner" << "-nostats" << "-i" << filePath
+         << "-ac" << QString::number(channels);
+    if (probe.sampleRate <= 0)
+        args << "-ar" << QString::number(sampleRate);
+    args << "-f" << "f32le"
+         << "pipe:1";
+
+    QProcess ff;
+    ff.start(ffmpegPath, args);
+    if (!ff.waitForStarted()) {
+        emit finished(loadId, false, tr("Impossible de lancer FFmpeg."));
+        return;
+    }
+
+    static QRegularExpression durationRegex("Duration: (\\d+):(\\d{2}):(\\d{2}\\.\\d+)");
+    QByteArray errorLog;
+    QByteArray partialFrame;  // Fin d'une trame coupée entre deux lectures du tube
+    const qsizetype frameBytes = channels * qsizetype(sizeof(float));
+    qint64 expectedSamples = static_cast<qint64>(probe.duration * sampleRate);
+    lastEmit.start();
+
+    // On est dans le thread de chargement : on peut attendre le tube sans geler l'interface
+    while (true) {
+        if (cancelRequested) {
+            ff.kill();
+            ff.waitForFinished(1000);
+            emit finished(loadId, false, QString());
+            return;
+        }
+
+        const bool running = (ff.state() != QProcess::NotRunning);
+        if (running) ff.waitForReadyRead(50);
+
+        // La ligne "Duration: HH:MM:SS.xx" arrive sur stderr avant les données
+        errorLog += ff.readAllStandardError();
+        if (errorLog.size() > 16384) errorLog = errorLog.right(16384);
+        if (!infoSent && expectedSamples == 0) {
+            QRegularExpressionMatch match = durationRegex.match(QString::fromLatin1(errorLog));
+            if (match.hasMatch()) {
+                double seconds = match.captured(1).toInt() * 3600.0
+                               + match.captured(2).toInt() * 60.0
+                               + match.captured(3).toDouble();
+                expectedSamples = static_cast<qint64>(seconds * sampleRate);
+            }
+        }
+
+        QByteArray data = ff.readAllStandardOutput();
+        if (data.isEmpty()) {
+            if (!running) break;
+            flushPending(false);
+            continue;
+        }
+
+        if (!infoSent) {
+            emit streamInfo(loadId, sampleRate, channels, expectedSamples);
+            expectedFrames = expectedSamples;
+            infoSent = true;
+        }
+
+        if (!partialFrame.isEmpty()) {
+            data.prepend(partialFrame);
+            partialFrame.clear();
+        }
+        const qsizetype count = data.size() / frameBytes;
+        const qsizetype rest = data.size() - count * frameBytes;
+        if (rest > 0) partialFrame = data.right(rest);
+
+        if (count > 0)
+            appendInterleaved(data.constData(), QAudioFormat::Float, count, channels);
+        flushPending(false);
+    }
+
+    flushPending(true);
+
+    if (ff.exitStatus() != QProcess::NormalExit || ff.exitCode() != 0) {
+        emit finished(loadId, false,
+                      tr("La commande FFmpeg a échoué.\n%1").arg(QString::fromLocal8Bit(errorLog)));
+        return;
+    }
+    emit finished(loadId, true, QString());
+}
+
+// ============================================================================
+// CHARGEMENT VIA QAUDIODECODER (WAV)
+// ============================================================================
+
+void AudioLoader::loadWithDecoder(int loadId, const QString &filePath)
+{
+    stopDecoder();
+    cancelRequested = false;
+    currentLoadId = loadId;
+    infoSent = false;
+    pending.clear();
+    expectedFrames = 0;
+    deliveredFrames = 0;
+    lastEmit.start();
+
+    // Le décodeur est créé dans ce thread : ses signaux sont traités par la
+    // boucle d'événements du thread de chargement, pas par celle de l'interface
+    decoder = new QAudioDecoder(this);
+    connect(decoder, &QAudioDecoder::bufferReady, this, [this]() {
+        QAudioBuffer buf = decoder->read();
+        processBuffer(buf);
+    });
+    connect(decoder, &QAudioDecoder::finished, this, &AudioLoader::decodingFinished);
+    connect(decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [this](QAudioDecoder::Error) {
+        const QString message = decoder->errorString();
+        stopDecoder();
+        pending.clear();
+        emit finished(currentLoadId, false, message);
+    });
+
+    decoder->setSource(QUrl::fromLocalFile(filePath));
+    decoder->start();
+}
+
+void AudioLoader::processBuffer(const QAudioBuffer &buf)
+{
+    if (cancelRequested) {
+        stopDecoder();
+        pending.clear();
+        emit finished(currentLoadId, false, QString());
+        return;
+    }
+
+    const qsizetype frames = buf.frameCount();
+    if (frames <= 0) return;
+    const QAudioFormat fmt = buf.format();
+    const int ch = fmt.channelCount();
+
+    if (!infoSent) {
+        qint64 durationMs = decoder ? decoder->duration() : -1;
+        expectedFrames = (durationMs > 0) ? durationMs * fmt.sampleRate() / 1000 : 0;
+        emit streamInfo(currentLoadId, fmt.sampleRate(), ch, expectedFrames);
+        infoSent = true;
+    }
+
+    // Chaque canal est gardé tel quel, sans mixage
+    if (!appendInterleaved(buf.constData<char>(), fmt.sampleFormat(), frames, ch)) {
+        stopDecoder();
+        pending.clear();
+        emit finished(currentLoadId, false, tr("Format d'échantillons non pris en charge."));
+        return;
+    }
+    flushPending(false);
+}
+
+void AudioLoader::decodingFinished()
+{
+    stopDecoder();
+    flushPending(true);
+    emit finished(currentLoadId, true, QString());
+}
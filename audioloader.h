@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QElapsedTimer>
+#include <atomic>
+
+class QAudioDecoder;
+
+// Décode un fichier audio hors du thread graphique (FFmpeg ou QAudioDecoder)
+// et livre les échantillons par blocs, au fur et à mesure du décodage, à la
+// fréquence et avec les canaux d'origine (un vecteur par canal).
+// L'objet vit dans un QThread dédié : on l'appelle via QMetaObject::invokeMethod.
+class AudioLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AudioLoader(QObject *parent = nullptr);
+
+    // Appelable depuis n'importe quel thread : interrompt le décodage en cours
+    void cancel();
+
+public slots:
+    void loadWithFFmpeg(int loadId, const QString &filePath, const QString &ffmpegPath);
+    void loadWithDecoder(int loadId, const QString &filePath);
+
+signals:
+    // expectedSamples vaut 0 si la durée du fichier est inconnue
+    void streamInfo(int loadId, int sampleRate, int channelCount, qint64 expectedSamples);
+    void samplesDecoded(int loadId, const QVector<QVector<float>> &channels);
+    // errorMessage est vide si le chargement a été annulé
+    void finished(int loadId, bool success, const QString &errorMessage);
+
+private slots:
+    void processBuffer(const QAudioBuffer &buffer);
+    void decodingFinished();
+
+private:
+    void flushPending(bool force);
+    // Convertit des trames entrelacées en float et les répartit dans pending
+    // (un vecteur par canal) ; false si le format n'est pas pris en charge
+    bool appendInterleaved(const void *frames, QAudioFormat::SampleFormat format, qsizetype count, int channels);
+    void stopDecoder();
+
+    std::atomic<bool> cancelRequested{false};
+    QAudioDecoder    *decoder = nullptr;
+    int               currentLoadId = 0;
+    bool              infoSent = false;
+    QVector<QVector<float>> pending;   // Échantillons décodés pas encore envoyés à l'interface
+    qint64            expectedFrames = 0;  // Longueur annoncée (0 si inconnue)
+    qint64            deliveredFrames = 0;
+    QElapsedTimer     lastEmit;
+};
@@ -6,12 +6,25 @@
 #include <QCoreApplication>
 #include <QFile>
 #include <QFileInfo>
-#include <QMediaPlayer>
-#include <QAudioOutput>
-#include <QUrl>
-#include <QTimer>
-#include <QEventLoop>
 #include <QDataStream>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QThread>
+#include <QTemporaryFile>
+#include <QDir>
+#include <QtEndian>
+#include <cstring>
+#include <memory>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// Taille des copies entre deux messages de progression (fusion native)
+static const qint64 NATIVE_COPY_STEP = qint64(64) * 1024 * 1024;
+// Tampon de la copie classique, quand le noyau ne sait pas copier lui-même
+static const qint64 NATIVE_BUFFER_SIZE = qint64(8) * 1024 * 1024;
 
 // ============================================================================
 // CONFIGURATION MULTIPLATEFORME FFMPEG
@@ -49,32 +62,87 @@ QString AudioMerger::getFFmpegPath()
 // CODE EXISTANT AVEC MODIFICATIONS
 // ============================================================================
 
+AudioMerger::~AudioMerger() {
+    // Une fusion native en cours écrit encore le fichier : on attend qu'elle se termine
+    if (nativeMergeThread) nativeMergeThread->wait();
+}
+
 AudioMerger::AudioMerger(QObject* parent) : QObject(parent), totalDurationInSeconds(0) {
     ffmpegProcess = new QProcess(this);
     
-    ffmpegProcess->setProcessChannelMode(QProcess::MergedChannels);
+    // stdout : avancement structuré (-progress pipe:1) ; stderr : journal, pour les erreurs
+    ffmpegProcess->setProcessChannelMode(QProcess::SeparateChannels);
 
     connect(ffmpegProcess, &QProcess::finished, this, &AudioMerger::processFinished);
     connect(ffmpegProcess, &QProcess::errorOccurred, this, &AudioMerger::processError);
 
-    connect(ffmpegProcess, &QProcess::readyReadStandardOutput, [this]() {
-        QByteArray data = ffmpegProcess->readAllStandardOutput();
-        QString output = QString::fromLatin1(data);
-
-        static QRegularExpression timeRegex("time=(\\d{2}:\\d{2}:\\d{2})\\.\\d+");
-        QRegularExpressionMatch match = timeRegex.match(output);
+    connect(ffmpegProcess, &QProcess::readyReadStandardOutput, this, &AudioMerger::readProgressOutput);
+    connect(ffmpegProcess, &QProcess::readyReadStandardError, this, [this]() {
+        errorLog += ffmpegProcess->readAllStandardError();
+        if (errorLog.size() > 16384) errorLog = errorLog.right(16384);
+    });
+}
 
-        if (match.hasMatch()) {
-            QString currentTimeStr = match.captured(1); 
+void AudioMerger::readProgressOutput() {
+    progressBuffer += ffmpegProcess->readAllStandardOutput();
+
+    // Les lignes peuvent arriver coupées entre deux lectures : on ne traite que les complètes
+    qsizetype newline;
+    while ((newline = progressBuffer.indexOf('\n')) >= 0) {
+        const QByteArray line = progressBuffer.left(newline).trimmed();
+        progressBuffer.remove(0, newline + 1);
+
+        const qsizetype eq = line.indexOf('=');
+        if (eq <= 0) continue;
+        const QByteArray key = line.left(eq);
+        const QByteArray value = line.mid(eq + 1);
+
+        if (key == "out_time_us" || key == "out_time_ms") {
+            // out_time_ms est aussi en microsecondes (nom historique de FFmpeg)
+            bool ok = false;
+            const qint64 us = value.toLongLong(&ok);
+            if (ok && us >= 0) currentProgress.processedSeconds = us / 1e6;
+        } else if (key == "total_size") {
+            bool ok = false;
+            const qint64 bytes = value.toLongLong(&ok);
+            if (ok) currentProgress.outputBytes = bytes;
+        } else if (key == "speed") {
+            // "12.3x", ou "N/A" au démarrage
+            bool ok = false;
+            const double speed = value.left(value.size() - 1).toDouble(&ok);
+            currentProgress.speed = ok ? speed : 0.0;
+        } else if (key == "progress") {
+            // Fin d'un bloc : FFmpeg en envoie un toutes les 0,5 s environ
+            publishProgress(currentProgress, value == "end");
+        }
+    }
+}
 
-            if (totalDurationInSeconds > 0.1) {
-                QString totalTimeStr = formatTime(totalDurationInSeconds);
-                emit statusMessage(QString("Traitement : %1 / %2").arg(currentTimeStr).arg(totalTimeStr));
-            } else {
-                emit statusMessage(QString("Traitement : %1").arg(currentTimeStr));
-            }
+void AudioMerger::publishProgress(MergeProgress p, bool force) {
+    if (!force && lastProgressEmit.isValid() && lastProgressEmit.elapsed() < 250) return;
+    lastProgressEmit.restart();
+
+    if (totalDurationInSeconds > 0.1) {
+        p.fraction = qBound(0.0, p.processedSeconds / totalDurationInSeconds, 1.0);
+        const double remaining = totalDurationInSeconds - p.processedSeconds;
+        if (p.speed > 0.0) {
+            p.etaSeconds = qMax(0.0, remaining / p.speed);
+        } else if (p.fraction > 0.0) {
+            // Pas de vitesse annoncée : on extrapole le temps déjà passé
+            const double elapsed = mergeClock.elapsed() / 1000.0;
+            p.etaSeconds = elapsed * (1.0 - p.fraction) / p.fraction;
         }
-    });
+    }
+    emit progress(p);
+
+    QString message = QString("Traitement : %1").arg(formatTime(p.processedSeconds));
+    if (p.fraction >= 0.0) {
+        message += QString(" / %1 (%2 %)").arg(formatTime(totalDurationInSeconds))
+                                           .arg(int(p.fraction * 100));
+    }
+    if (p.speed > 0.0) message += QString(" - x%1").arg(p.speed, 0, 'f', 1);
+    if (p.etaSeconds >= 0.0) message += QString(" - reste %1").arg(formatTime(p.etaSeconds));
+    emit statusMessage(message);
 }
 
 QString AudioMerger::formatTime(double seconds) {
@@ -89,129 +157,165 @@ QString AudioMerger::formatTime(double seconds) {
             .arg(s, 2, 10, QChar('0'));
 }
 
-double AudioMerger::getFileDuration(const QString &file) {
-    QFileInfo fi(file);
-    if (!fi.exists()) return 0.0;
-
-    // OPTIMISATION : Si c'est un WAV, on lit l'en-tête directement (très rapide)
-    if (fi.suffix().compare("wav", Qt::CaseInsensitive) == 0) {
-        return getWavDuration(file);
-    }
-
-    // POUR LES AUTRES FORMATS (MP3, M4A, ETC.) : On utilise QMediaPlayer
-    // Note : QMediaPlayer est asynchrone, nous devons utiliser une boucle d'événement locale
-    // pour rendre la fonction synchrone (bloquante) comme l'était votre appel ffprobe.
-
-    QMediaPlayer player;
-    QAudioOutput audioOutput;
-    player.setAudioOutput(&audioOutput);
-    
-    QEventLoop loop;
-    
-    // On quitte la boucle quand les métadonnées sont chargées
-    connect(&player, &QMediaPlayer::mediaStatusChanged, [&](QMediaPlayer::MediaStatus status){
-        if (status == QMediaPlayer::BufferedMedia || status == QMediaPlayer::LoadedMedia) {
-            loop.quit();
-        }
-    });
+// ----------------------------------------------------------------------------
+// Fusion native des WAV (sans décodage)
+// ----------------------------------------------------------------------------
+bool AudioMerger::sameWavFormat(const AudioProber::WavInfo &a, const AudioProber::WavInfo &b) {
+    if (a.formatTag != b.formatTag || a.channels != b.channels || a.sampleRate != b.sampleRate
+        || a.blockAlign != b.blockAlign || a.bitsPerSample != b.bitsPerSample)
+        return false;
+    // Format étendu : le sous-format et la disposition des canaux doivent aussi correspondre
+    return a.formatTag != 0xFFFE || a.fmtChunk == b.fmtChunk;
+}
 
-    // On quitte aussi en cas d'erreur
-    connect(&player, &QMediaPlayer::errorOccurred, [&](QMediaPlayer::Error error, const QString &errorString){
-        Q_UNUSED(error);
-        Q_UNUSED(errorString);
-        loop.quit();
-    });
+bool AudioMerger::canMergeNatively(const QStringList &inputFiles, const QString &outputFile,
+                                   const QVector<AudioProber::Info> &infos) {
+    if (!outputFile.endsWith(".wav", Qt::CaseInsensitive)) return false;
 
-    // Sécurité : Timeout de 2 secondes max (au cas où le fichier est corrompu)
-    QTimer::singleShot(2000, &loop, &QEventLoop::quit);
+    const QString outputPath = QFileInfo(outputFile).absoluteFilePath();
+    for (int i = 0; i < inputFiles.size(); ++i) {
+        if (QFileInfo(inputFiles[i]).absoluteFilePath() == outputPath) return false;
 
-    player.setSource(QUrl::fromLocalFile(file));
-    
-    // Si le fichier n'est pas instantanément chargé, on attend
-    if (player.mediaStatus() != QMediaPlayer::BufferedMedia && 
-        player.mediaStatus() != QMediaPlayer::LoadedMedia) {
-        loop.exec();
+        const AudioProber::Info &info = infos[i];
+        if (!info.isWav) return false;
+        // PCM entier ou float uniquement (pas d'ADPCM & co)
+        const quint16 tag = info.wav.formatTag;
+        if (tag != 1 && tag != 3 && tag != 0xFFFE) return false;
+        if (!sameWavFormat(infos.first().wav, info.wav)) return false;
     }
+    return !inputFiles.isEmpty();
+}
 
-    qint64 durationMs = player.duration();
-    
-    if (durationMs > 0) {
-        return durationMs / 1000.0;
+// Copie [inOffset, inOffset + size) de in vers out à outOffset. Sous Linux le
+// noyau copie directement entre les fichiers (copy_file_range, voire reflink) ;
+// sinon, ou s'il refuse (systèmes de fichiers différents...), copie par tampon.
+static bool copyFileRange(QFile &in, qint64 inOffset, QFile &out, qint64 outOffset, qint64 size) {
+#if defined(Q_OS_LINUX)
+    loff_t src = inOffset, dst = outOffset;
+    qint64 remaining = size;
+    while (remaining > 0) {
+        const ssize_t n = ::copy_file_range(in.handle(), &src, out.handle(), &dst, size_t(remaining), 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            break;   // Non pris en charge ou fin inattendue : on termine par tampon
+        }
+        remaining -= n;
     }
+    inOffset += size - remaining;
+    outOffset += size - remaining;
+    size = remaining;
+    if (size == 0) return true;
+#endif
 
-    return 0.0;
+    if (!in.seek(inOffset) || !out.seek(outOffset)) return false;
+    std::unique_ptr<char[]> buffer(new char[NATIVE_BUFFER_SIZE]);
+    while (size > 0) {
+        const qint64 n = in.read(buffer.get(), std::min(size, NATIVE_BUFFER_SIZE));
+        if (n <= 0 || out.write(buffer.get(), n) != n) return false;
+        size -= n;
+    }
+    return out.flush();
 }
 
-// ----------------------------------------------------------------------------
-// Lecture rapide header WAV
-// ----------------------------------------------------------------------------
-double AudioMerger::getWavDuration(const QString &file) {
-    QFile f(file);
-    if (!f.open(QIODevice::ReadOnly)) return 0.0;
-
-    QDataStream in(&f);
-    in.setByteOrder(QDataStream::LittleEndian);
-
-    char riff[4];
-    in.readRawData(riff, 4); // "RIFF"
-    if (strncmp(riff, "RIFF", 4) != 0) return 0.0;
-
-    in.skipRawData(4); // File size
-
-    char wave[4];
-    in.readRawData(wave, 4); // "WAVE"
-    if (strncmp(wave, "WAVE", 4) != 0) return 0.0;
-
-    // On parcourt les chunks jusqu'à trouver "fmt " et "data"
-    quint32 sampleRate = 0;
-    quint16 bitsPerSample = 0;
-    quint16 channels = 0;
-    quint32 dataSize = 0;
-    bool fmtFound = false;
-    bool dataFound = false;
-
-    while (!in.atEnd() && (!fmtFound || !dataFound)) {
-        char chunkId[4];
-        if (in.readRawData(chunkId, 4) != 4) break;
-        
-        quint32 chunkSize;
-        in >> chunkSize;
-
-        if (strncmp(chunkId, "fmt ", 4) == 0) {
-            quint16 audioFormat;
-            in >> audioFormat;
-            in >> channels;
-            in >> sampleRate;
-            in.skipRawData(6); // ByteRate (4) + BlockAlign (2)
-            in >> bitsPerSample;
-            
-            // Si le chunk fmt est plus grand que 16 octets (ex: extension header), on saute le reste
-            if (chunkSize > 16) in.skipRawData(chunkSize - 16);
-            
-            fmtFound = true;
-        } 
-        else if (strncmp(chunkId, "data", 4) == 0) {
-            dataSize = chunkSize;
-            dataFound = true;
-            // Pas besoin de lire les données, on a la taille
-            break; 
-        } 
-        else {
-            // Chunk inconnu (ex: LIST, ID3, JUNK), on saute
-            in.skipRawData(chunkSize);
-        }
+bool AudioMerger::concatWavFiles(const QStringList &inputFiles, const QString &outputFile,
+                                 const QVector<AudioProber::Info> &infos, QString &errorMessage) {
+    const AudioProber::WavInfo &format = infos.first().wav;
+    qint64 totalData = 0;
+    for (const AudioProber::Info &info : infos) totalData += info.wav.dataSize;
+    const qint64 pad = totalData & 1;
+
+    // Un seul en-tête, avec les tailles finales ; RF64 au-delà de 4 Go
+    const quint32 fmtSize = quint32(format.fmtChunk.size());
+    const quint64 riffSize = 4 + (8 + fmtSize + (fmtSize & 1)) + (8 + quint64(totalData + pad));
+    const bool rf64 = riffSize > 0xFFFFFFFFull;
+
+    QByteArray header;
+    auto put32 = [&header](quint32 v) { char b[4]; qToLittleEndian(v, b); header.append(b, 4); };
+    auto put64 = [&header](quint64 v) { char b[8]; qToLittleEndian(v, b); header.append(b, 8); };
+    header.append(rf64 ? "RF64" : "RIFF", 4);
+    put32(rf64 ? 0xFFFFFFFFu : quint32(riffSize));
+    header.append("WAVE", 4);
+    if (rf64) {
+        header.append("ds64", 4);
+        put32(28);
+        put64(riffSize + 8 + 28);
+        put64(quint64(totalData));
+        put64(quint64(totalData / format.blockAlign));
+        put32(0);
+    }
+    header.append("fmt ", 4);
+    put32(fmtSize);
+    header.append(format.fmtChunk);
+    if (fmtSize & 1) header.append('\0');
+    header.append("data", 4);
+    put32(rf64 ? 0xFFFFFFFFu : quint32(totalData));
+
+    QFile out(outputFile);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = "Impossible de créer le fichier : " + out.errorString();
+        return false;
+    }
+    if (out.write(header) != header.size() || !out.flush()) {
+        errorMessage = "Erreur d'écriture : " + out.errorString();
+        return false;
     }
 
-    f.close();
+    const double byteRate = double(format.sampleRate) * format.blockAlign;
+    qint64 outOffset = header.size();
+    for (int i = 0; i < inputFiles.size(); ++i) {
+        QFile in(inputFiles[i]);
+        if (!in.open(QIODevice::ReadOnly)) {
+            errorMessage = "Impossible de lire " + inputFiles[i] + " : " + in.errorString();
+            return false;
+        }
+        // Par tranches, pour tenir la barre d'état à jour
+        const AudioProber::WavInfo &wav = infos[i].wav;
+        for (qint64 done = 0; done < wav.dataSize; done += NATIVE_COPY_STEP) {
+            const qint64 n = std::min(NATIVE_COPY_STEP, wav.dataSize - done);
+            if (!copyFileRange(in, wav.dataOffset + done, out, outOffset, n)) {
+                errorMessage = "Erreur de copie : " + out.errorString();
+                return false;
+            }
+            outOffset += n;
+
+            MergeProgress p;
+            p.processedSeconds = (outOffset - header.size()) / byteRate;
+            p.outputBytes = outOffset;
+            const double elapsed = mergeClock.elapsed() / 1000.0;
+            if (elapsed > 0.0) p.speed = p.processedSeconds / elapsed;
+            publishProgress(p, outOffset - header.size() == totalData);
+        }
+    }
 
-    if (fmtFound && dataFound && sampleRate > 0 && channels > 0 && bitsPerSample > 0) {
-        // Formule : TailleData / (TauxEchantillonnage * Canaux * OctetsParEchantillon)
-        double bytesPerSample = bitsPerSample / 8.0;
-        return (double)dataSize / (sampleRate * channels * bytesPerSample);
+    if (pad && (!out.seek(outOffset) || out.write("\0", 1) != 1)) {
+        errorMessage = "Erreur d'écriture : " + out.errorString();
+        return false;
     }
-    
-    // Si échec lecture header, fallback sur méthode lente (rare)
-    return 0.0;
+    out.close();
+    return true;
+}
+
+void AudioMerger::startNativeMerge(const QStringList &inputFiles, const QString &outputFile,
+                                   const QVector<AudioProber::Info> &infos) {
+    nativeMergeThread = QThread::create([this, inputFiles, outputFile, infos]() {
+        QString errorMessage;
+        const bool ok = concatWavFiles(inputFiles, outputFile, infos, errorMessage);
+        if (!ok) QFile::remove(outputFile);
+
+        // Retour dans le thread de l'interface pour signaler la fin
+        QMetaObject::invokeMethod(this, [this, ok, errorMessage]() {
+            nativeMergeThread->wait();
+            nativeMergeThread->deleteLater();
+            nativeMergeThread = nullptr;
+            if (ok) {
+                emit statusMessage("Finalisation...");
+                emit finished(true);
+            } else {
+                emit error(errorMessage);
+            }
+        });
+    });
+    nativeMergeThread->start();
 }
 
 bool AudioMerger::checkFFmpeg() {
@@ -231,15 +335,72 @@ void AudioMerger::mergeFiles(const QStringList& inputFiles, const QString& outpu
         return;
     }
 
+    emit started();
+    emit statusMessage(QString("Analyse des fichiers : 0 / %1").arg(inputFiles.size()));
+
+    // Durées et formats lus en parallèle, hors du thread de l'interface ;
+    // les fichiers déjà analysés (même taille, même date) sortent du cache
+    const QString ffmpegPath = getFFmpegPath();
+    auto *watcher = new QFutureWatcher<AudioProber::Info>(this);
+    connect(watcher, &QFutureWatcher<AudioProber::Info>::progressValueChanged, this, [this, watcher](int done) {
+        emit statusMessage(QString("Analyse des fichiers : %1 / %2").arg(done).arg(watcher->progressMaximum()));
+    });
+    connect(watcher, &QFutureWatcher<AudioProber::Info>::finished, this, [this, watcher, inputFiles, outputFile]() {
+        const QList<AudioProber::Info> results = watcher->future().results();
+        watcher->deleteLater();
+        startMerge(inputFiles, outputFile, QVector<AudioProber::Info>(results.begin(), results.end()));
+    });
+    watcher->setFuture(QtConcurrent::mapped(inputFiles, [ffmpegPath](const QString &file) {
+        return AudioProber::probe(file, ffmpegPath);
+    }));
+}
+
+void AudioMerger::startMerge(const QStringList &inputFiles, const QString &outputFile,
+                             const QVector<AudioProber::Info> &infos) {
     // Calcul de la durée totale
     totalDurationInSeconds = 0;
-    for (const QString& file : inputFiles) {
-        totalDurationInSeconds += getFileDuration(file);
+    for (const AudioProber::Info &info : infos) {
+        totalDurationInSeconds += info.duration;
+    }
+
+    progressBuffer.clear();
+    errorLog.clear();
+    currentProgress = MergeProgress();
+    lastProgressEmit.invalidate();
+    mergeClock.start();
+
+    // WAV de même format vers un WAV : simple copie des données, sans FFmpeg
+    if (canMergeNatively(inputFiles, outputFile, infos)) {
+        startNativeMerge(inputFiles, outputFile, infos);
+        return;
     }
 
     // MODIFICATION : Utiliser getFFmpegPath()
     QString ffmpegPath = getFFmpegPath();
     
+    QStringList arguments;
+    fallbackArguments.clear();
+    cleanupConcatList();
+
+    // Même codec, même fréquence, mêmes canaux : on recopie les paquets tels quels
+    if (canStreamCopy(inputFiles, outputFile, infos)) {
+        arguments = streamCopyArguments(inputFiles, outputFile);
+        if (!arguments.isEmpty())
+            fallbackArguments = filterGraphArguments(inputFiles, outputFile);
+    }
+    if (arguments.isEmpty())
+        arguments = filterGraphArguments(inputFiles, outputFile);
+
+    ffmpegProcess->start(ffmpegPath, progressArguments() + arguments);
+    ffmpegProcess->closeWriteChannel();
+}
+
+// Avancement lisible par la machine sur stdout, pas de ligne "size=... time=..." sur stderr
+QStringList AudioMerger::progressArguments() {
+    return QStringList() << "-hide_banner" << "-nostats" << "-progress" << "pipe:1";
+}
+
+QStringList AudioMerger::filterGraphArguments(const QStringList &inputFiles, const QString &outputFile) {
     QStringList arguments;
 
     if (inputFiles.size() == 1) {
@@ -254,18 +415,98 @@ void AudioMerger::mergeFiles(const QStringList& inputFiles, const QString& outpu
         arguments << "-map" << "[out]";
         arguments << "-y" << outputFile;
     }
+    return arguments;
+}
 
-    ffmpegProcess->start(ffmpegPath, arguments);
-    ffmpegProcess->closeWriteChannel();
+// ----------------------------------------------------------------------------
+// Fusion par copie de flux (sans réencodage)
+// ----------------------------------------------------------------------------
+// Codecs qu'un conteneur de sortie peut recevoir tels quels
+static bool codecFitsExtension(const QString &codec, const QString &extension) {
+    const QString ext = extension.toLower();
+    if (ext == "mp3") return codec == "mp3";
+    if (ext == "m4a" || ext == "aac" || ext == "mp4") return codec == "aac" || codec == "alac";
+    if (ext == "flac") return codec == "flac";
+    if (ext == "ogg") return codec == "vorbis" || codec == "opus" || codec == "flac";
+    if (ext == "opus") return codec == "opus";
+    if (ext == "wav") return codec.startsWith("pcm_");
+    return false;
+}
 
-    emit started();
+bool AudioMerger::canStreamCopy(const QStringList &inputFiles, const QString &outputFile,
+                                const QVector<AudioProber::Info> &infos) {
+    const QString extension = QFileInfo(outputFile).suffix();
+    const QString outputPath = QFileInfo(outputFile).absoluteFilePath();
+
+    for (int i = 0; i < inputFiles.size(); ++i) {
+        if (QFileInfo(inputFiles[i]).absoluteFilePath() == outputPath) return false;
+
+        const AudioProber::Info &info = infos[i];
+        const AudioProber::Info &reference = infos.first();
+        if (!info.valid || !codecFitsExtension(info.codec, extension)) return false;
+        if (info.codec != reference.codec || info.sampleRate != reference.sampleRate
+            || info.channelLayout != reference.channelLayout) {
+            return false;
+        }
+    }
+    return !inputFiles.isEmpty();
+}
+
+QStringList AudioMerger::streamCopyArguments(const QStringList &inputFiles, const QString &outputFile) {
+    // Liste "file '...'" lue par le démultiplexeur concat ; les apostrophes
+    // des chemins s'échappent en '\''
+    concatList = new QTemporaryFile(QDir::tempPath() + "/son_fusion_concat_XXXXXX.txt", this);
+    if (!concatList->open()) {
+        cleanupConcatList();
+        return QStringList();
+    }
+    for (const QString &file : inputFiles) {
+        QString path = QFileInfo(file).absoluteFilePath();
+        path.replace("'", "'\\''");
+        concatList->write("file '" + path.toUtf8() + "'\n");
+    }
+    concatList->close();   // Le nom reste réservé jusqu'à la destruction
+
+    QStringList arguments;
+    arguments << "-f" << "concat" << "-safe" << "0"
+              << "-i" << concatList->fileName()
+              << "-map" << "0:a"          // Ni pochette ni autres flux
+              << "-c" << "copy"
+              << "-y" << outputFile;
+    return arguments;
+}
+
+void AudioMerger::cleanupConcatList() {
+    delete concatList;
+    concatList = nullptr;
 }
 
 void AudioMerger::processFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    const bool ok = (exitCode == 0 && exitStatus == QProcess::NormalExit);
+
+    // La copie de flux a échoué (fichier atypique...) : on refait la fusion avec réencodage
+    if (!ok && !fallbackArguments.isEmpty()) {
+        const QStringList arguments = fallbackArguments;
+        fallbackArguments.clear();
+        cleanupConcatList();
+        emit statusMessage("Copie directe impossible, réencodage...");
+        progressBuffer.clear();
+        currentProgress = MergeProgress();
+        ffmpegProcess->start(getFFmpegPath(), progressArguments() + arguments);
+        ffmpegProcess->closeWriteChannel();
+        return;
+    }
+
+    fallbackArguments.clear();
+    cleanupConcatList();
     emit statusMessage("Finalisation..."); 
-    emit finished(exitCode == 0 && exitStatus == QProcess::NormalExit);
+    emit finished(ok);
 }
 
 void AudioMerger::processError(QProcess::ProcessError error) {
+    // Un échec en cours de route se termine aussi par finished() : la reprise s'y fait
+    if (error == QProcess::Crashed && !fallbackArguments.isEmpty()) return;
+    fallbackArguments.clear();
+    cleanupConcatList();
     emit this->error("Erreur FFmpeg code: " + QString::number(error));
 }
\ No newline at end of file
@@ -2,13 +2,31 @@
 #define AUDIOMERGER_H
 
 #include <QObject>
+#include <QElapsedTimer>
+#include <QMetaType>
 #include <QProcess>
 #include <QStringList>
+#include <QVector>
+#include "audioprober.h"
+
+class QThread;
+class QTemporaryFile;
+
+// Avancement d'une fusion (FFmpeg ou copie native)
+struct MergeProgress {
+    double fraction = -1.0;         // 0..1, négatif si la durée totale est inconnue
+    double processedSeconds = 0.0;  // Durée de son déjà produite
+    double speed = 0.0;             // Multiple du temps réel (x1.0 = temps réel)
+    double etaSeconds = -1.0;       // Temps restant estimé, négatif si inconnu
+    qint64 outputBytes = 0;         // Taille actuelle du fichier produit
+};
+Q_DECLARE_METATYPE(MergeProgress)
 
 class AudioMerger : public QObject {
     Q_OBJECT
 public:
     AudioMerger(QObject* parent = nullptr);
+    ~AudioMerger();
     bool checkFFmpeg();
     void mergeFiles(const QStringList& inputFiles, const QString& outputFile);
 
@@ -17,6 +35,8 @@ signals:
     void finished(bool success);
     void error(const QString& message);
     void statusMessage(const QString& message); 
+    // Au plus quelques fois par seconde, plus une dernière fois à la fin
+    void progress(const MergeProgress& progress);
 
 private slots:
     void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
@@ -24,14 +44,46 @@ private slots:
 
 private:
     QProcess* ffmpegProcess;
+    QThread* nativeMergeThread = nullptr;
+    QTemporaryFile* concatList = nullptr;   // Liste du démultiplexeur concat (copie de flux)
+    QStringList fallbackArguments;          // Graphe de filtres, si la copie de flux échoue
     double totalDurationInSeconds;
+
+    // Lecture de "-progress pipe:1" : blocs de lignes clé=valeur terminés par "progress=..."
+    QByteArray progressBuffer;      // Fin de ligne pas encore reçue
+    QByteArray errorLog;            // Fin de la sortie d'erreur, pour les messages
+    MergeProgress currentProgress;
+    QElapsedTimer mergeClock;       // Temps écoulé depuis le début de la fusion
+    QElapsedTimer lastProgressEmit; // Utilisé par un seul thread à la fois (FFmpeg ou copie native)
+    void readProgressOutput();
+    void publishProgress(MergeProgress p, bool force);
+
+    static bool sameWavFormat(const AudioProber::WavInfo &a, const AudioProber::WavInfo &b);
+
+    // Suite de mergeFiles, une fois les fichiers analysés
+    void startMerge(const QStringList &inputFiles, const QString &outputFile,
+                    const QVector<AudioProber::Info> &infos);
+
+    // Fusion native : en-têtes identiques, on recopie les blocs "data" bout à bout
+    bool canMergeNatively(const QStringList &inputFiles, const QString &outputFile,
+                          const QVector<AudioProber::Info> &infos);
+    void startNativeMerge(const QStringList &inputFiles, const QString &outputFile,
+                          const QVector<AudioProber::Info> &infos);
+    bool concatWavFiles(const QStringList &inputFiles, const QString &outputFile,
+                        const QVector<AudioProber::Info> &infos, QString &errorMessage);
+
+    // Fusion sans réencodage (démultiplexeur concat + "-c copy") si les codecs le permettent
+    bool canStreamCopy(const QStringList &inputFiles, const QString &outputFile,
+                       const QVector<AudioProber::Info> &infos);
+    QStringList streamCopyArguments(const QStringList &inputFiles, const QString &outputFile);
+    static QStringList progressArguments();
+    QStringList filterGraphArguments(const QStringList &inputFiles, const QString &outputFile);
+    void cleanupConcatList();
     
     // NOUVEAUX : Méthodes multiplateforme
     QString getFFmpegPath();
     
     
-    double getFileDuration(const QString &file);
-    double getWavDuration(const QString &file);
     QString formatTime(double seconds);
 };
 
@@ -0,0 +1,288 @@
+#include "audioplayback.h"
+#include "dspkernels.h"
+
+#include <QAudioDevice>
+#include <QAudioSink>
+#include <QIODevice>
+#include <QMediaDevices>
+#include <QMutex>
+#include <atomic>
+
+// Intervalle de mise à jour de la tête de lecture (~60 images/s)
+static const int POSITION_INTERVAL_MS = 16;
+// Au-delà, on n'extrapole plus entre deux avancées de l'horloge de la sortie
+// (sortie en manque de données, machine surchargée...)
+static const qint64 MAX_INTERPOLATION_US = 100000;
+
+// ============================================================================
+// SAMPLESTREAM : QIODevice en lecture seule sur un MultiChannelBuffer
+// ============================================================================
+
+// Le QAudioSink vient y chercher ses données (mode « pull »). Selon la
+// plateforme, readData peut être appelé depuis le thread audio : le signal
+// est protégé par un mutex, la position est atomique.
+class SampleStream : public QIODevice
+{
+public:
+    explicit SampleStream(QObject *parent = nullptr) : QIODevice(parent) {}
+
+    void setFormat(const QAudioFormat &fmt)
+    {
+        QMutexLocker lock(&mutex);
+        format = fmt;
+    }
+
+    void setSamples(const MultiChannelBuffer &s)
+    {
+        QMutexLocker lock(&mutex);
+        samples = s;    // Copie de la liste des morceaux seulement
+    }
+
+    // Lecture de [start, end) ; end < 0 : jusqu'à la fin du signal
+    void setRange(qint64 start, qint64 end)
+    {
+        pos = std::max<qint64>(0, start);
+        stopAt = end;
+    }
+    qint64 position() const { return pos; }
+
+    bool atSignalEnd() const
+    {
+        QMutexLocker lock(&mutex);
+        return pos >= limit();
+    }
+
+    bool isSequential() const override { return true; }
+
+    qint64 bytesAvailable() const override
+    {
+        QMutexLocker lock(&mutex);
+        const qint64 frames = std::max<qint64>(0, limit() - pos);
+        return frames * format.bytesPerFrame() + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        QMutexLocker lock(&mutex);
+        const int frameBytes = format.bytesPerFrame();
+        if (frameBytes <= 0) return 0;
+
+        const qint64 start = pos;
+        const qint64 frames = std::min(maxSize / frameBytes, limit() - start);
+        if (frames <= 0) return 0;
+
+        const int channels = format.channelCount();
+        const int sourceChannels = samples.channelCount();
+        const QAudioFormat::SampleFormat sampleFormat = format.sampleFormat();
+
+        // Un bloc illisible (readInterleaved() < 0) est rendu comme du silence :
+        // la lecture continue plutôt que d'interrompre le thread audio
+        // Cas courant : mêmes canaux, float : copie directe des trames entrelacées
+        if (sampleFormat == QAudioFormat::Float && channels == sourceChannels) {
+            samples.readInterleaved(start, reinterpret_cast<float *>(data), frames);
+            pos = start + frames;
+            return frames * frameBytes;
+        }
+
+        const qsizetype values = qsizetype(frames) * sourceChannels;
+        if (scratch.size() < values) scratch.resize(values);
+        samples.readInterleaved(start, scratch.data(), frames);
+
+        // Canal de sortie c : moyenne des canaux source s ≡ c (mod channels),
+        // ou canal c % sourceChannels si la sortie en a plus (mono -> stéréo)
+        const float *mixed = scratch.constData();
+        if (channels != sourceChannels) {
+            const qsizetype mixedValues = qsizetype(frames) * channels;
+            if (mixScratch.size() < mixedValues) mixScratch.resize(mixedValues);
+            DspKernels::downmix(scratch.constData(), sourceChannels, mixScratch.data(), channels, frames);
+            mixed = mixScratch.constData();
+        }
+
+        const qint64 n = frames * channels;
+        if (sampleFormat == QAudioFormat::Float) {
+            DspKernels::clamp(mixed, reinterpret_cast<float *>(data), n, -1.0f, 1.0f);
+        } else if (sampleFormat == QAudioFormat::Int32) {
+            DspKernels::floatToInt32(mixed, reinterpret_cast<qint32 *>(data), n, 2147483648.0f, 32);
+        } else {
+            DspKernels::floatToInt16(mixed, reinterpret_cast<qint16 *>(data), n);
+        }
+
+        pos = start + frames;
+        return frames * frameBytes;
+    }
+
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    // Appelé sous le mutex
+    qint64 limit() const
+    {
+        const qint64 end = stopAt;
+        return (end < 0) ? samples.size() : std::min(end, samples.size());
+    }
+
+    mutable QMutex      mutex;
+    MultiChannelBuffer  samples;
+    QVector<float>      scratch;    // Trames entrelacées avant conversion
+    QVector<float>      mixScratch; // Trames remixées au nombre de canaux de la sortie
+    QAudioFormat        format;
+    std::atomic<qint64> pos{0};
+    std::atomic<qint64> stopAt{-1};
+};
+
+// ============================================================================
+// AUDIOPLAYBACK
+// ============================================================================
+
+AudioPlayback::AudioPlayback(QObject *parent)
+    : QObject(parent)
+    , stream(new SampleStream(this))
+{
+    stream->open(QIODevice::ReadOnly);
+
+    positionTimer.setInterval(POSITION_INTERVAL_MS);
+    connect(&positionTimer, &QTimer::timeout, this, [this]() {
+        emit positionChanged(position());
+    });
+}
+
+AudioPlayback::~AudioPlayback()
+{
+    stop();
+}
+
+void AudioPlayback::createSink(int sampleRate, int channelCount)
+{
+    delete sink;
+    sink = nullptr;
+
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+
+    // On préfère le float avec les canaux du signal (copie directe des trames),
+    // sinon ce que la sortie accepte
+    bool found = false;
+    for (QAudioFormat::SampleFormat sampleFormat : {QAudioFormat::Float, QAudioFormat::Int16}) {
+        for (int channels : {channelCount, 2, 1}) {
+            QAudioFormat candidate;
+            candidate.setSampleRate(sampleRate);
+            candidate.setChannelCount(channels);
+            candidate.setSampleFormat(sampleFormat);
+            if (device.isFormatSupported(candidate)) {
+                format = candidate;
+                found = true;
+                break;
+            }
+        }
+        if (found) break;
+    }
+    if (!found) {
+        format = device.preferredFormat();
+        format.setSampleRate(sampleRate);
+        if (format.sampleFormat() != QAudioFormat::Float && format.sampleFormat() != QAudioFormat::Int32)
+            format.setSampleFormat(QAudioFormat::Int16);
+    }
+
+    stream->setFormat(format);
+    sink = new QAudioSink(device, format, this);
+    sink->setVolume(volume);
+    connect(sink, &QAudioSink::stateChanged, this, &AudioPlayback::handleSinkState);
+}
+
+void AudioPlayback::setSamples(const MultiChannelBuffer &samples, int sampleRate)
+{
+    const int channels = std::max(1, samples.channelCount());
+    if (!sink || format.sampleRate() != sampleRate || sourceChannels != channels) {
+        stop();
+        createSink(sampleRate, channels);
+        sourceChannels = channels;
+    }
+    stream->setSamples(samples);
+}
+
+void AudioPlayback::play(qint64 start, qint64 end)
+{
+    if (!sink) return;
+
+    sink->stop();
+    startSample = std::max<qint64>(0, start);
+    lastPosition = startSample;
+    lastProcessedUs = -1;
+    stream->setRange(startSample, end);
+    sink->start(stream);
+    positionTimer.start();
+    emit positionChanged(startSample);
+}
+
+void AudioPlayback::pause()
+{
+    if (state() != PlayingState) return;
+    sink->suspend();
+    positionTimer.stop();
+}
+
+void AudioPlayback::resume()
+{
+    if (state() != PausedState) return;
+    sink->resume();
+    positionTimer.start();
+}
+
+void AudioPlayback::stop()
+{
+    positionTimer.stop();
+    if (sink) sink->stop();
+}
+
+AudioPlayback::State AudioPlayback::state() const
+{
+    if (!sink) return StoppedState;
+    switch (sink->state()) {
+    case QAudio::ActiveState:
+    case QAudio::IdleState:
+        return PlayingState;
+    case QAudio::SuspendedState:
+        return PausedState;
+    default:
+        return StoppedState;
+    }
+}
+
+qint64 AudioPlayback::position() const
+{
+    if (state() == StoppedState || format.sampleRate() <= 0) return lastPosition;
+
+    // Horloge de la sortie : durée réellement jouée depuis start() (hors pauses).
+    // Elle n'avance qu'à chaque période audio : entre deux, on extrapole avec
+    // une horloge locale pour que la tête de lecture glisse sans à-coups.
+    const qint64 processedUs = sink->processedUSecs();
+    if (processedUs != lastProcessedUs) {
+        lastProcessedUs = processedUs;
+        sinceProcessed.restart();
+    }
+    qint64 extraUs = 0;
+    if (sink->state() == QAudio::ActiveState)
+        extraUs = std::min(sinceProcessed.nsecsElapsed() / 1000, MAX_INTERPOLATION_US);
+
+    const qint64 played = (processedUs + extraUs) * format.sampleRate() / 1000000;
+    // Jamais au-delà de ce qui a été remis à la sortie, ni en arrière
+    lastPosition = qBound(lastPosition, startSample + played, stream->position());
+    return lastPosition;
+}
+
+void AudioPlayback::setVolume(float v)
+{
+    volume = v;
+    if (sink) sink->setVolume(volume);
+}
+
+void AudioPlayback::handleSinkState()
+{
+    if (sink->state() == QAudio::IdleState && stream->atSignalEnd()) {
+        // Tout a été joué
+        stop();
+        emit finished();
+    } else if (sink->state() == QAudio::StoppedState) {
+        positionTimer.stop();
+    }
+}
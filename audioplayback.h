@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QObject>
+#include <QAudioFormat>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "samplebuffer.h"
+
+class QAudioSink;
+class SampleStream;
+
+// Lecture directe du signal en mémoire : un QAudioSink tire les échantillons
+// d'un QIODevice qui parcourt une copie du signal (listes de morceaux
+// seulement). Après une modification, il suffit de redonner le signal :
+// aucun fichier intermédiaire, la lecture repart immédiatement.
+class AudioPlayback : public QObject
+{
+    Q_OBJECT
+public:
+    enum State { StoppedState, PlayingState, PausedState };
+
+    explicit AudioPlayback(QObject *parent = nullptr);
+    ~AudioPlayback();
+
+    // Remplace le signal lu ; possible pendant la lecture (ex. pendant le
+    // décodage, pour suivre les échantillons qui arrivent)
+    // Les canaux sont joués tels quels si la sortie les accepte, sinon répartis
+    // sur ceux de la sortie (mixage ou duplication)
+    void setSamples(const MultiChannelBuffer &samples, int sampleRate);
+
+    // Joue [start, end) ; end < 0 : jusqu'à la fin. La lecture s'arrête
+    // exactement sur end, au sample près (fin de sélection)
+    void play(qint64 start, qint64 end = -1);
+    void pause();
+    void resume();
+    void stop();
+
+    State state() const;
+    // Échantillon entendu en ce moment, d'après l'horloge de la sortie audio
+    qint64 position() const;
+    void setVolume(float volume);
+
+signals:
+    void positionChanged(qint64 sampleIndex);
+    void finished();            // Fin du signal atteinte
+
+private:
+    void createSink(int sampleRate, int channels);
+    void handleSinkState();
+
+    QAudioSink   *sink = nullptr;
+    SampleStream *stream = nullptr;
+    QAudioFormat  format;
+    QTimer        positionTimer;
+    float         volume = 1.0f;
+    int           sourceChannels = 0;
+
+    qint64                startSample = 0;
+    mutable qint64        lastPosition = 0;
+    mutable qint64        lastProcessedUs = -1;
+    mutable QElapsedTimer sinceProcessed;
+};
@@ -0,0 +1,355 @@
+#include "audioprober.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <cstring>
+
+// Octets lus en tête de fichier pour trouver la première trame MP3
+static const qint64 MP3_SCAN_BYTES = 128 * 1024;
+
+// ============================================================================
+// CACHE
+// ============================================================================
+
+namespace {
+struct CachedInfo {
+    qint64 size = 0;
+    qint64 mtime = 0;
+    AudioProber::Info info;
+};
+
+QMutex cacheMutex;
+QHash<QString, CachedInfo> cache;   // Clé : chemin absolu
+}
+
+AudioProber::Info AudioProber::probe(const QString &file, const QString &ffmpegPath)
+{
+    const QFileInfo fi(file);
+    if (!fi.exists()) return Info();
+
+    const QString key = fi.absoluteFilePath();
+    const qint64 size = fi.size();
+    const qint64 mtime = fi.lastModified().toMSecsSinceEpoch();
+    {
+        QMutexLocker lock(&cacheMutex);
+        auto it = cache.constFind(key);
+        if (it != cache.constEnd() && it->size == size && it->mtime == mtime)
+            return it->info;
+    }
+
+    const Info info = probeUncached(file, ffmpegPath);
+    if (info.valid) {
+        QMutexLocker lock(&cacheMutex);
+        cache.insert(key, CachedInfo{size, mtime, info});
+    }
+    return info;
+}
+
+AudioProber::Info AudioProber::probeUncached(const QString &file, const QString &ffmpegPath)
+{
+    Info info;
+    const QString suffix = QFileInfo(file).suffix().toLower();
+
+    // Lecture directe des en-têtes : pas de processus, quelques Ko lus
+    if (suffix == "wav" && probeWav(file, info)) return info;
+    if (suffix == "flac" && probeFlac(file, info)) return info;
+    if (suffix == "mp3" && probeMp3(file, info)) return info;
+
+    info = Info();
+    probeWithFFmpeg(file, ffmpegPath, info);
+    return info;
+}
+
+static QString layoutName(int channels)
+{
+    if (channels == 1) return "mono";
+    if (channels == 2) return "stereo";
+    return QString("%1 channels").arg(channels);
+}
+
+// Nombre de canaux d'après le nom de disposition de FFmpeg ; 0 si inconnu
+static int layoutChannels(const QString &layout)
+{
+    static const QHash<QString, int> known = {
+        {"mono", 1}, {"stereo", 2}, {"2.1", 3}, {"3.0", 3}, {"quad", 4}, {"4.0", 4},
+        {"4.1", 5}, {"5.0", 5}, {"5.0(side)", 5}, {"5.1", 6}, {"5.1(side)", 6},
+        {"6.1", 7}, {"7.1", 8}, {"7.1(wide)", 8},
+    };
+    if (known.contains(layout)) return known.value(layout);
+    static const QRegularExpression countRegex("^(\\d+) channels");
+    const QRegularExpressionMatch match = countRegex.match(layout);
+    return match.hasMatch() ? match.captured(1).toInt() : 0;
+}
+
+// ============================================================================
+// WAV
+// ============================================================================
+
+bool AudioProber::readWavInfo(const QString &file, WavInfo &info)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    char header[12];
+    if (f.read(header, 12) != 12) return false;
+    const bool rf64 = (strncmp(header, "RF64", 4) == 0);
+    if (!rf64 && strncmp(header, "RIFF", 4) != 0) return false;
+    if (strncmp(header + 8, "WAVE", 4) != 0) return false;
+
+    // On parcourt les chunks jusqu'à trouver "fmt " et "data"
+    quint64 ds64DataSize = 0;
+    bool fmtFound = false;
+
+    while (true) {
+        char chunk[8];
+        if (f.read(chunk, 8) != 8) return false;
+        const quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const qint64 chunkStart = f.pos();
+
+        if (strncmp(chunk, "ds64", 4) == 0) {
+            // RF64 : les vraies tailles 64 bits (RIFF, data, nombre d'échantillons)
+            QByteArray ds64 = f.read(chunkSize);
+            if (ds64.size() < 16) return false;
+            ds64DataSize = qFromLittleEndian<quint64>(ds64.constData() + 8);
+        }
+        else if (strncmp(chunk, "fmt ", 4) == 0) {
+            info.fmtChunk = f.read(chunkSize);
+            if (info.fmtChunk.size() < 16) return false;
+            const char *d = info.fmtChunk.constData();
+            info.formatTag     = qFromLittleEndian<quint16>(d);
+            info.channels      = qFromLittleEndian<quint16>(d + 2);
+            info.sampleRate    = qFromLittleEndian<quint32>(d + 4);
+            info.blockAlign    = qFromLittleEndian<quint16>(d + 12);
+            info.bitsPerSample = qFromLittleEndian<quint16>(d + 14);
+            fmtFound = true;
+        }
+        else if (strncmp(chunk, "data", 4) == 0) {
+            info.dataOffset = f.pos();
+            info.dataSize = (rf64 && chunkSize == 0xFFFFFFFFu) ? qint64(ds64DataSize) : qint64(chunkSize);
+            // Fichier tronqué ou écrit en flux (taille inconnue) : on s'en tient au fichier
+            info.dataSize = qBound<qint64>(0, info.dataSize, f.size() - info.dataOffset);
+            break;
+        }
+
+        // Chunk suivant (on saute aussi les inconnus : LIST, ID3, JUNK...) ;
+        // les chunks de taille impaire sont suivis d'un octet de bourrage
+        if (!f.seek(chunkStart + chunkSize + (chunkSize & 1)))
+            return false;
+    }
+
+    return fmtFound && info.sampleRate > 0 && info.channels > 0 && info.blockAlign > 0;
+}
+
+bool AudioProber::probeWav(const QString &file, Info &info)
+{
+    if (!readWavInfo(file, info.wav)) return false;
+
+    const WavInfo &w = info.wav;
+    // Formule : TailleData / (TauxEchantillonnage * Canaux * OctetsParEchantillon)
+    info.duration = double(w.dataSize) / (double(w.sampleRate) * w.blockAlign);
+    info.sampleRate = int(w.sampleRate);
+    info.channels = w.channels;
+    info.channelLayout = layoutName(w.channels);
+
+    // Même nommage que FFmpeg, pour comparer les fichiers entre eux
+    quint16 tag = w.formatTag;
+    if (tag == 0xFFFE && w.fmtChunk.size() >= 26)
+        tag = qFromLittleEndian<quint16>(w.fmtChunk.constData() + 24);   // Sous-format
+    if (tag == 3)
+        info.codec = QString("pcm_f%1le").arg(w.bitsPerSample);
+    else if (tag == 1)
+        info.codec = (w.bitsPerSample == 8) ? QString("pcm_u8") : QString("pcm_s%1le").arg(w.bitsPerSample);
+    else
+        info.codec = QString("wav_0x%1").arg(tag, 4, 16, QChar('0'));
+
+    info.isWav = true;
+    info.valid = true;
+    return true;
+}
+
+// ============================================================================
+// FLAC : bloc STREAMINFO
+// ============================================================================
+
+// Taille d'une éventuelle étiquette ID3v2 en tête de fichier
+static qint64 id3v2Size(const uchar *d, qint64 n)
+{
+    if (n < 10 || std::memcmp(d, "ID3", 3) != 0) return 0;
+    // Taille « synchsafe » : 4 x 7 bits
+    qint64 size = (qint64(d[6] & 0x7F) << 21) | ((d[7] & 0x7F) << 14) | ((d[8] & 0x7F) << 7) | (d[9] & 0x7F);
+    size += 10;
+    if (d[5] & 0x10) size += 10;   // Pied de page
+    return size;
+}
+
+bool AudioProber::probeFlac(const QString &file, Info &info)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QByteArray head = f.read(10);
+    const qint64 skip = id3v2Size(reinterpret_cast<const uchar *>(head.constData()), head.size());
+    if (!f.seek(skip)) return false;
+
+    // "fLaC", puis l'en-tête du premier bloc (toujours STREAMINFO, 34 octets)
+    const QByteArray block = f.read(4 + 4 + 34);
+    if (block.size() < 42 || std::memcmp(block.constData(), "fLaC", 4) != 0) return false;
+    const uchar *d = reinterpret_cast<const uchar *>(block.constData());
+    if ((d[4] & 0x7F) != 0) return false;
+
+    const uchar *si = d + 8;
+    const int sampleRate = (si[10] << 12) | (si[11] << 4) | (si[12] >> 4);
+    const int channels = ((si[12] >> 1) & 0x07) + 1;
+    const quint64 totalSamples = (quint64(si[13] & 0x0F) << 32)
+                               | (quint64(si[14]) << 24) | (quint64(si[15]) << 16)
+                               | (quint64(si[16]) << 8) | quint64(si[17]);
+    if (sampleRate <= 0 || totalSamples == 0) return false;   // Longueur inconnue : FFmpeg
+
+    info.duration = double(totalSamples) / sampleRate;
+    info.codec = "flac";
+    info.sampleRate = sampleRate;
+    info.channels = channels;
+    info.channelLayout = layoutName(channels);
+    info.valid = true;
+    return true;
+}
+
+// ============================================================================
+// MP3 : première trame, en-tête Xing / Info / VBRI, sinon débit constant
+// ============================================================================
+
+namespace {
+struct Mp3Frame {
+    int version = 0;        // 1 = MPEG-1, 2 = MPEG-2, 25 = MPEG-2.5
+    int bitrate = 0;        // bits/s
+    int sampleRate = 0;
+    bool mono = false;
+    int length = 0;         // Octets, en-tête compris
+    int samplesPerFrame = 0;
+};
+
+bool parseMp3Header(const uchar *h, Mp3Frame &frame)
+{
+    if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) return false;
+    const int versionBits = (h[1] >> 3) & 0x03;
+    const int layerBits = (h[1] >> 1) & 0x03;
+    const int bitrateIndex = h[2] >> 4;
+    const int rateIndex = (h[2] >> 2) & 0x03;
+    if (versionBits == 1 || layerBits != 1) return false;     // Réservé, ou pas Layer III
+    if (bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) return false;
+
+    static const int bitratesV1[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+    static const int bitratesV2[16] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+    static const int ratesV1[3] = { 44100, 48000, 32000 };
+
+    frame.version = (versionBits == 3) ? 1 : (versionBits == 2 ? 2 : 25);
+    frame.bitrate = (frame.version == 1 ? bitratesV1 : bitratesV2)[bitrateIndex] * 1000;
+    frame.sampleRate = ratesV1[rateIndex] / (frame.version == 1 ? 1 : (frame.version == 2 ? 2 : 4));
+    frame.mono = ((h[3] >> 6) == 3);
+    frame.samplesPerFrame = (frame.version == 1) ? 1152 : 576;
+    const int padding = (h[2] >> 1) & 0x01;
+    frame.length = (frame.samplesPerFrame / 8) * frame.bitrate / frame.sampleRate + padding;
+    return frame.length > 4;
+}
+
+quint32 readBE32(const uchar *d)
+{
+    return (quint32(d[0]) << 24) | (quint32(d[1]) << 16) | (quint32(d[2]) << 8) | quint32(d[3]);
+}
+}
+
+bool AudioProber::probeMp3(const QString &file, Info &info)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    const qint64 fileSize = f.size();
+
+    QByteArray head = f.read(10);
+    const qint64 audioStart = id3v2Size(reinterpret_cast<const uchar *>(head.constData()), head.size());
+    if (!f.seek(audioStart)) return false;
+    const QByteArray buf = f.read(MP3_SCAN_BYTES);
+    const uchar *d = reinterpret_cast<const uchar *>(buf.constData());
+    const qint64 n = buf.size();
+
+    // Première trame valide suivie d'une seconde : évite les faux synchronismes
+    Mp3Frame frame;
+    qint64 pos = 0;
+    for (; pos + 4 <= n; ++pos) {
+        Mp3Frame next;
+        if (parseMp3Header(d + pos, frame)
+            && pos + frame.length + 4 <= n
+            && parseMp3Header(d + pos + frame.length, next))
+            break;
+    }
+    if (pos + 4 > n) return false;
+
+    const qint64 sideInfo = (frame.version == 1) ? (frame.mono ? 17 : 32) : (frame.mono ? 9 : 17);
+    const uchar *xing = d + pos + 4 + sideInfo;
+    const uchar *vbri = d + pos + 4 + 32;
+    qint64 frames = 0;
+
+    if (pos + 4 + sideInfo + 12 <= n
+        && (std::memcmp(xing, "Xing", 4) == 0 || std::memcmp(xing, "Info", 4) == 0)) {
+        if (readBE32(xing + 4) & 0x01) frames = readBE32(xing + 8);
+    } else if (pos + 4 + 32 + 18 <= n && std::memcmp(vbri, "VBRI", 4) == 0) {
+        frames = readBE32(vbri + 14);
+    }
+
+    if (frames > 0) {
+        info.duration = double(frames) * frame.samplesPerFrame / frame.sampleRate;
+    } else {
+        // Débit constant : taille des données audio (hors étiquette ID3v1) / débit
+        qint64 audioBytes = fileSize - audioStart - pos;
+        if (fileSize >= 128 && f.seek(fileSize - 128) && f.read(3) == "TAG") audioBytes -= 128;
+        info.duration = double(audioBytes) * 8.0 / frame.bitrate;
+    }
+
+    info.codec = "mp3";
+    info.sampleRate = frame.sampleRate;
+    info.channels = frame.mono ? 1 : 2;
+    info.channelLayout = frame.mono ? "mono" : "stereo";
+    info.valid = info.duration > 0;
+    return info.valid;
+}
+
+// ============================================================================
+// AUTRES FORMATS : FFMPEG
+// ============================================================================
+
+bool AudioProber::probeWithFFmpeg(const QString &file, const QString &ffmpegPath, Info &info)
+{
+    QProcess process;
+    process.start(ffmpegPath, QStringList() << "-hide_banner" << "-i" << file);
+    if (!process.waitForStarted()) return false;
+    process.waitForFinished(10000);
+
+    // FFmpeg écrit les infos techniques sur stderr.
+    // Ex : "Duration: 00:03:12.45, start: ..." puis
+    //      "Stream #0:0: Audio: mp3 (mp3float), 44100 Hz, stereo, fltp, 128 kb/s"
+    const QString output = QString::fromUtf8(process.readAllStandardError());
+
+    static const QRegularExpression durationRegex("Duration: (\\d+):(\\d{2}):(\\d{2}(?:\\.\\d+)?)");
+    QRegularExpressionMatch match = durationRegex.match(output);
+    if (match.hasMatch()) {
+        info.duration = match.captured(1).toInt() * 3600.0
+                      + match.captured(2).toInt() * 60.0
+                      + match.captured(3).toDouble();
+    }
+
+    static const QRegularExpression streamRegex("Stream #\\d+:\\d+[^:]*: Audio: ([\\w-]+)[^,]*, (\\d+) Hz, ([^,]+),");
+    match = streamRegex.match(output);
+    if (!match.hasMatch()) return false;
+
+    info.codec = match.captured(1);
+    info.sampleRate = match.captured(2).toInt();
+    info.channelLayout = match.captured(3).trimmed();
+    info.channels = layoutChannels(info.channelLayout);
+    info.valid = true;
+    return true;
+}
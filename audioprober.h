@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+// Lecture des métadonnées d'un fichier audio (durée, codec, fréquence, canaux).
+// Les en-têtes WAV, FLAC et MP3 sont lus directement ; les autres formats
+// passent par "ffmpeg -i". Les résultats sont gardés en mémoire, identifiés
+// par chemin + taille + date de modification. Les fonctions sont sûres entre
+// threads : on peut sonder plusieurs fichiers en parallèle (QtConcurrent).
+class AudioProber
+{
+public:
+    // Description d'un WAV lue dans ses en-têtes (RIFF ou RF64)
+    struct WavInfo {
+        quint16 formatTag = 0;      // 1 = PCM, 3 = float, 0xFFFE = extensible
+        quint16 channels = 0;
+        quint32 sampleRate = 0;
+        quint16 blockAlign = 0;
+        quint16 bitsPerSample = 0;
+        QByteArray fmtChunk;        // Contenu brut du bloc "fmt ", recopié tel quel
+        qint64 dataOffset = 0;
+        qint64 dataSize = 0;
+    };
+
+    struct Info {
+        bool valid = false;
+        double duration = 0.0;      // Secondes, 0 si inconnue
+        QString codec;              // Nom FFmpeg : "mp3", "aac", "pcm_s16le"...
+        int sampleRate = 0;
+        int channels = 0;           // 0 si inconnu
+        QString channelLayout;      // "mono", "stereo", "5.1"...
+        bool isWav = false;
+        WavInfo wav;                // Renseigné si isWav
+    };
+
+    static Info probe(const QString &file, const QString &ffmpegPath);
+
+    static bool readWavInfo(const QString &file, WavInfo &info);
+
+private:
+    static Info probeUncached(const QString &file, const QString &ffmpegPath);
+    static bool probeWav(const QString &file, Info &info);
+    static bool probeFlac(const QString &file, Info &info);
+    static bool probeMp3(const QString &file, Info &info);
+    static bool probeWithFFmpeg(const QString &file, const QString &ffmpegPath, Info &info);
+};
@@ -0,0 +1,886 @@
+#include "dspkernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define DSP_SSE2
+#define DSP_AVX2
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DSP_TARGET_AVX2
+#else
+// Seules ces fonctions sont compilées pour AVX2 ; le reste du programme
+// garde la cible de base
+#define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DSP_NEON
+#endif
+
+// Bornes d'un entier signé de bits bits, en float. 2^31 - 1 n'est pas
+// représentable : on prend le plus grand float inférieur (2^31 - 128).
+static void intRange(int bits, float &lo, float &hi)
+{
+    lo = -float(qint64(1) << (bits - 1));
+    hi = bits >= 32 ? 2147483520.0f : float((qint64(1) << (bits - 1)) - 1);
+}
+
+// ============================================================================
+// VERSIONS SCALAIRES (aussi utilisées pour la fin des boucles vectorielles)
+// ============================================================================
+
+[[maybe_unused]] static float absMaxScalar(const float *src, qint64 n)
+{
+    float m = 0.0f;
+    for (qint64 i = 0; i < n; ++i)
+        m = std::max(m, std::fabs(src[i]));
+    return m;
+}
+
+[[maybe_unused]] static void minMaxScalar(const float *src, qint64 n, float &mn, float &mx)
+{
+    for (qint64 i = 0; i < n; ++i) {
+        mn = std::min(mn, src[i]);
+        mx = std::max(mx, src[i]);
+    }
+}
+
+// Somme des carrés sur 8 accumulateurs double : l'échantillon i va toujours
+// dans l'accumulateur i % 8 et la réduction finale suit le même arbre. x² est
+// exact en double (24 bits de mantisse au carré), le total est donc identique
+// d'une variante à l'autre, contraction en FMA comprise.
+static double sumSquaresFinish(const float *src, qint64 n, double acc[8])
+{
+    // n < 8 : la fin de la dernière série de 8
+    for (qint64 i = 0; i < n; ++i) {
+        const double v = src[i];
+        acc[i] += v * v;
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+[[maybe_unused]] static double sumSquaresScalar(const float *src, qint64 n)
+{
+    double acc[8] = {};
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int k = 0; k < 8; ++k) {
+            const double v = src[i + k];
+            acc[k] += v * v;
+        }
+    }
+    return sumSquaresFinish(src + i, n - i, acc);
+}
+
+[[maybe_unused]] static void scaleScalar(const float *src, float *dst, qint64 n, float gain)
+{
+    for (qint64 i = 0; i < n; ++i)
+        dst[i] = src[i] * gain;
+}
+
+[[maybe_unused]] static void clampScalar(const float *src, float *dst, qint64 n, float lo, float hi)
+{
+    for (qint64 i = 0; i < n; ++i)
+        dst[i] = std::min(std::max(src[i], lo), hi);
+}
+
+[[maybe_unused]] static void toInt16Scalar(const float *src, qint16 *dst, qint64 n, float scale)
+{
+    for (qint64 i = 0; i < n; ++i)
+        dst[i] = qint16(std::lrint(std::min(std::max(src[i] * scale, -32768.0f), 32767.0f)));
+}
+
+[[maybe_unused]] static void toInt32Scalar(const float *src, qint32 *dst, qint64 n, float scale, float lo, float hi)
+{
+    for (qint64 i = 0; i < n; ++i)
+        dst[i] = qint32(std::lrint(double(std::min(std::max(src[i] * scale, lo), hi))));
+}
+
+[[maybe_unused]] static void int16ToFloatScalar(const qint16 *src, float *dst, qint64 n)
+{
+    for (qint64 i = 0; i < n; ++i)
+        dst[i] = src[i] * (1.0f / 32768.0f);
+}
+
+// Canaux lus avec un pas de channels échantillons, à partir de la trame from
+template<typename T>
+static void deinterleaveScalar(const T *src, int channels, qint64 from, qint64 frames,
+                               float *const *dst, float scale, float bias)
+{
+    for (int c = 0; c < channels; ++c) {
+        const T *in = src + c;
+        float *out = dst[c];
+        for (qint64 i = from; i < frames; ++i)
+            out[i] = (float(in[i * channels]) - bias) * scale;
+    }
+}
+
+[[maybe_unused]] static void deinterleaveFloatScalar(const float *src, int channels, qint64 frames, float *const *dst)
+{
+    deinterleaveScalar(src, channels, 0, frames, dst, 1.0f, 0.0f);
+}
+
+[[maybe_unused]] static void deinterleaveInt16Scalar(const qint16 *src, int channels, qint64 frames, float *const *dst)
+{
+    deinterleaveScalar(src, channels, 0, frames, dst, 1.0f / 32768.0f, 0.0f);
+}
+
+[[maybe_unused]] static void deinterleaveInt32Scalar(const qint32 *src, int channels, qint64 frames, float *const *dst)
+{
+    deinterleaveScalar(src, channels, 0, frames, dst, 1.0f / 2147483648.0f, 0.0f);
+}
+
+static void downmixScalar(const float *src, int srcChannels, float *dst, int dstChannels, qint64 from, qint64 frames)
+{
+    for (qint64 i = from; i < frames; ++i) {
+        const float *in = src + i * srcChannels;
+        float *out = dst + i * dstChannels;
+        for (int c = 0; c < dstChannels; ++c) {
+            if (srcChannels > dstChannels) {
+                float v = 0.0f;
+                int n = 0;
+                for (int s = c; s < srcChannels; s += dstChannels, ++n)
+                    v += in[s];
+                out[c] = v / n;
+            } else {
+                out[c] = in[c % srcChannels];
+            }
+        }
+    }
+}
+
+[[maybe_unused]] static void downmixAllScalar(const float *src, int srcChannels, float *dst, int dstChannels, qint64 frames)
+{
+    downmixScalar(src, srcChannels, dst, dstChannels, 0, frames);
+}
+
+// ============================================================================
+// SSE2
+// ============================================================================
+
+#if defined(DSP_SSE2)
+
+static inline float hmax(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+static inline float hmin(__m128 v)
+{
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+static float absMaxSse2(const float *src, qint64 n)
+{
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 m0 = _mm_setzero_ps(), m1 = _mm_setzero_ps();
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        m0 = _mm_max_ps(m0, _mm_and_ps(_mm_loadu_ps(src + i), mask));
+        m1 = _mm_max_ps(m1, _mm_and_ps(_mm_loadu_ps(src + i + 4), mask));
+    }
+    return std::max(hmax(_mm_max_ps(m0, m1)), absMaxScalar(src + i, n - i));
+}
+
+static void minMaxSse2(const float *src, qint64 n, float &mn, float &mx)
+{
+    qint64 i = 0;
+    if (n >= 4) {
+        __m128 vmn = _mm_set1_ps(mn), vmx = _mm_set1_ps(mx);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 v = _mm_loadu_ps(src + i);
+            vmn = _mm_min_ps(vmn, v);
+            vmx = _mm_max_ps(vmx, v);
+        }
+        mn = hmin(vmn);
+        mx = hmax(vmx);
+    }
+    minMaxScalar(src + i, n - i, mn, mx);
+}
+
+static double sumSquaresSse2(const float *src, qint64 n)
+{
+    // Accumulateurs 0-1, 2-3, 4-5 et 6-7
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd(), a2 = _mm_setzero_pd(), a3 = _mm_setzero_pd();
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128 x = _mm_loadu_ps(src + i);
+        const __m128 y = _mm_loadu_ps(src + i + 4);
+        const __m128d x0 = _mm_cvtps_pd(x), x1 = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+        const __m128d y0 = _mm_cvtps_pd(y), y1 = _mm_cvtps_pd(_mm_movehl_ps(y, y));
+        a0 = _mm_add_pd(a0, _mm_mul_pd(x0, x0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(x1, x1));
+        a2 = _mm_add_pd(a2, _mm_mul_pd(y0, y0));
+        a3 = _mm_add_pd(a3, _mm_mul_pd(y1, y1));
+    }
+    double acc[8];
+    _mm_storeu_pd(acc, a0);
+    _mm_storeu_pd(acc + 2, a1);
+    _mm_storeu_pd(acc + 4, a2);
+    _mm_storeu_pd(acc + 6, a3);
+    return sumSquaresFinish(src + i, n - i, acc);
+}
+
+static void scaleSse2(const float *src, float *dst, qint64 n, float gain)
+{
+    const __m128 g = _mm_set1_ps(gain);
+    qint64 i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+    scaleScalar(src + i, dst + i, n - i, gain);
+}
+
+static void clampSse2(const float *src, float *dst, qint64 n, float lo, float hi)
+{
+    const __m128 vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+    qint64 i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), vlo), vhi));
+    clampScalar(src + i, dst + i, n - i, lo, hi);
+}
+
+static void toInt16Sse2(const float *src, qint16 *dst, qint64 n, float scale)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 vlo = _mm_set1_ps(-32768.0f), vhi = _mm_set1_ps(32767.0f);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), vscale), vlo), vhi);
+        const __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), vscale), vlo), vhi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+    toInt16Scalar(src + i, dst + i, n - i, scale);
+}
+
+static void toInt32Sse2(const float *src, qint32 *dst, qint64 n, float scale, float lo, float hi)
+{
+    const __m128 vscale = _mm_set1_ps(scale), vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+    qint64 i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), vscale), vlo), vhi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_cvtps_epi32(a));
+    }
+    toInt32Scalar(src + i, dst + i, n - i, scale, lo, hi);
+}
+
+static void int16ToFloatSse2(const qint16 *src, float *dst, qint64 n)
+{
+    const __m128 vscale = _mm_set1_ps(1.0f / 32768.0f);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // Extension de signe : l'int16 dans la moitié haute d'un int32, puis décalage
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+    }
+    int16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+// Répartition : boucles vectorielles pour le mono et le stéréo, l'immense
+// majorité des fichiers ; au-delà, la boucle par canal
+static void deinterleaveFloatSse2(const float *src, int channels, qint64 frames, float *const *dst)
+{
+    if (channels == 1) {
+        std::memcpy(dst[0], src, frames * sizeof(float));
+        return;
+    }
+    qint64 i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const __m128 a = _mm_loadu_ps(src + 2 * i);         // L0 R0 L1 R1
+            const __m128 b = _mm_loadu_ps(src + 2 * i + 4);     // L2 R2 L3 R3
+            _mm_storeu_ps(dst[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(dst[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+    deinterleaveScalar(src, channels, i, frames, dst, 1.0f, 0.0f);
+}
+
+static void deinterleaveInt16Sse2(const qint16 *src, int channels, qint64 frames, float *const *dst)
+{
+    if (channels == 1) {
+        int16ToFloatSse2(src, dst[0], frames);
+        return;
+    }
+    const __m128 vscale = _mm_set1_ps(1.0f / 32768.0f);
+    qint64 i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            // Une trame L R forme un int32 : L dans la moitié basse, R dans la haute
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i));
+            const __m128i l = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+            const __m128i r = _mm_srai_epi32(v, 16);
+            _mm_storeu_ps(dst[0] + i, _mm_mul_ps(_mm_cvtepi32_ps(l), vscale));
+            _mm_storeu_ps(dst[1] + i, _mm_mul_ps(_mm_cvtepi32_ps(r), vscale));
+        }
+    }
+    deinterleaveScalar(src, channels, i, frames, dst, 1.0f / 32768.0f, 0.0f);
+}
+
+static void deinterleaveInt32Sse2(const qint32 *src, int channels, qint64 frames, float *const *dst)
+{
+    const __m128 vscale = _mm_set1_ps(1.0f / 2147483648.0f);
+    qint64 i = 0;
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_ps(dst[0] + i, _mm_mul_ps(_mm_cvtepi32_ps(v), vscale));
+        }
+    } else if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const __m128 a = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i)));
+            const __m128 b = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i + 4)));
+            _mm_storeu_ps(dst[0] + i, _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), vscale));
+            _mm_storeu_ps(dst[1] + i, _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), vscale));
+        }
+    }
+    deinterleaveScalar(src, channels, i, frames, dst, 1.0f / 2147483648.0f, 0.0f);
+}
+
+static void downmixSse2(const float *src, int srcChannels, float *dst, int dstChannels, qint64 frames)
+{
+    qint64 i = 0;
+    if (srcChannels == 2 && dstChannels == 1) {
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= frames; i += 4) {
+            const __m128 a = _mm_loadu_ps(src + 2 * i);
+            const __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+            const __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+        }
+    } else if (srcChannels == 1 && dstChannels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const __m128 v = _mm_loadu_ps(src + i);
+            _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(v, v));
+            _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(v, v));
+        }
+    }
+    downmixScalar(src, srcChannels, dst, dstChannels, i, frames);
+}
+
+#endif // DSP_SSE2
+
+// ============================================================================
+// AVX2 (choisi à l'exécution)
+// ============================================================================
+
+#if defined(DSP_AVX2)
+
+static bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    // Le système doit aussi sauvegarder les registres YMM
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+DSP_TARGET_AVX2 static float absMaxAvx2(const float *src, qint64 n)
+{
+    const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 m0 = _mm256_setzero_ps(), m1 = _mm256_setzero_ps();
+    qint64 i = 0;
+    for (; i + 16 <= n; i += 16) {
+        m0 = _mm256_max_ps(m0, _mm256_and_ps(_mm256_loadu_ps(src + i), mask));
+        m1 = _mm256_max_ps(m1, _mm256_and_ps(_mm256_loadu_ps(src + i + 8), mask));
+    }
+    const __m256 m = _mm256_max_ps(m0, m1);
+    const float v = hmax(_mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1)));
+    return std::max(v, absMaxSse2(src + i, n - i));
+}
+
+DSP_TARGET_AVX2 static void minMaxAvx2(const float *src, qint64 n, float &mn, float &mx)
+{
+    qint64 i = 0;
+    if (n >= 8) {
+        __m256 vmn = _mm256_set1_ps(mn), vmx = _mm256_set1_ps(mx);
+        for (; i + 8 <= n; i += 8) {
+            const __m256 v = _mm256_loadu_ps(src + i);
+            vmn = _mm256_min_ps(vmn, v);
+            vmx = _mm256_max_ps(vmx, v);
+        }
+        mn = hmin(_mm_min_ps(_mm256_castps256_ps128(vmn), _mm256_extractf128_ps(vmn, 1)));
+        mx = hmax(_mm_max_ps(_mm256_castps256_ps128(vmx), _mm256_extractf128_ps(vmx, 1)));
+    }
+    minMaxScalar(src + i, n - i, mn, mx);
+}
+
+DSP_TARGET_AVX2 static double sumSquaresAvx2(const float *src, qint64 n)
+{
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256d x0 = _mm256_cvtps_pd(_mm_loadu_ps(src + i));
+        const __m256d x1 = _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4));
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(x0, x0));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(x1, x1));
+    }
+    double acc[8];
+    _mm256_storeu_pd(acc, a0);
+    _mm256_storeu_pd(acc + 4, a1);
+    return sumSquaresFinish(src + i, n - i, acc);
+}
+
+DSP_TARGET_AVX2 static void scaleAvx2(const float *src, float *dst, qint64 n, float gain)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+    scaleScalar(src + i, dst + i, n - i, gain);
+}
+
+DSP_TARGET_AVX2 static void clampAvx2(const float *src, float *dst, qint64 n, float lo, float hi)
+{
+    const __m256 vlo = _mm256_set1_ps(lo), vhi = _mm256_set1_ps(hi);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), vlo), vhi));
+    clampScalar(src + i, dst + i, n - i, lo, hi);
+}
+
+DSP_TARGET_AVX2 static void toInt16Avx2(const float *src, qint16 *dst, qint64 n, float scale)
+{
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vlo = _mm256_set1_ps(-32768.0f), vhi = _mm256_set1_ps(32767.0f);
+    qint64 i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), vscale), vlo), vhi);
+        const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), vscale), vlo), vhi);
+        // packs travaille par moitié de 128 bits : on remet les quarts dans l'ordre
+        const __m256i p = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_permute4x64_epi64(p, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    toInt16Scalar(src + i, dst + i, n - i, scale);
+}
+
+DSP_TARGET_AVX2 static void toInt32Avx2(const float *src, qint32 *dst, qint64 n, float scale, float lo, float hi)
+{
+    const __m256 vscale = _mm256_set1_ps(scale), vlo = _mm256_set1_ps(lo), vhi = _mm256_set1_ps(hi);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), vscale), vlo), vhi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_cvtps_epi32(a));
+    }
+    toInt32Scalar(src + i, dst + i, n - i, scale, lo, hi);
+}
+
+DSP_TARGET_AVX2 static void int16ToFloatAvx2(const qint16 *src, float *dst, qint64 n)
+{
+    const __m256 vscale = _mm256_set1_ps(1.0f / 32768.0f);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), vscale));
+    }
+    int16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+#endif // DSP_AVX2
+
+// ============================================================================
+// NEON (toujours présent sur ARM64)
+// ============================================================================
+
+#if defined(DSP_NEON)
+
+static float absMaxNeon(const float *src, qint64 n)
+{
+    float32x4_t m0 = vdupq_n_f32(0.0f), m1 = vdupq_n_f32(0.0f);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        m0 = vmaxq_f32(m0, vabsq_f32(vld1q_f32(src + i)));
+        m1 = vmaxq_f32(m1, vabsq_f32(vld1q_f32(src + i + 4)));
+    }
+    return std::max(vmaxvq_f32(vmaxq_f32(m0, m1)), absMaxScalar(src + i, n - i));
+}
+
+static void minMaxNeon(const float *src, qint64 n, float &mn, float &mx)
+{
+    qint64 i = 0;
+    if (n >= 4) {
+        float32x4_t vmn = vdupq_n_f32(mn), vmx = vdupq_n_f32(mx);
+        for (; i + 4 <= n; i += 4) {
+            const float32x4_t v = vld1q_f32(src + i);
+            vmn = vminq_f32(vmn, v);
+            vmx = vmaxq_f32(vmx, v);
+        }
+        mn = vminvq_f32(vmn);
+        mx = vmaxvq_f32(vmx);
+    }
+    minMaxScalar(src + i, n - i, mn, mx);
+}
+
+static double sumSquaresNeon(const float *src, qint64 n)
+{
+    float64x2_t a0 = vdupq_n_f64(0.0), a1 = vdupq_n_f64(0.0), a2 = vdupq_n_f64(0.0), a3 = vdupq_n_f64(0.0);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t x = vld1q_f32(src + i);
+        const float32x4_t y = vld1q_f32(src + i + 4);
+        const float64x2_t x0 = vcvt_f64_f32(vget_low_f32(x)), x1 = vcvt_high_f64_f32(x);
+        const float64x2_t y0 = vcvt_f64_f32(vget_low_f32(y)), y1 = vcvt_high_f64_f32(y);
+        a0 = vaddq_f64(a0, vmulq_f64(x0, x0));
+        a1 = vaddq_f64(a1, vmulq_f64(x1, x1));
+        a2 = vaddq_f64(a2, vmulq_f64(y0, y0));
+        a3 = vaddq_f64(a3, vmulq_f64(y1, y1));
+    }
+    double acc[8];
+    vst1q_f64(acc, a0);
+    vst1q_f64(acc + 2, a1);
+    vst1q_f64(acc + 4, a2);
+    vst1q_f64(acc + 6, a3);
+    return sumSquaresFinish(src + i, n - i, acc);
+}
+
+static void scaleNeon(const float *src, float *dst, qint64 n, float gain)
+{
+    qint64 i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+    scaleScalar(src + i, dst + i, n - i, gain);
+}
+
+static void clampNeon(const float *src, float *dst, qint64 n, float lo, float hi)
+{
+    const float32x4_t vlo = vdupq_n_f32(lo), vhi = vdupq_n_f32(hi);
+    qint64 i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vminq_f32(vmaxq_f32(vld1q_f32(src + i), vlo), vhi));
+    clampScalar(src + i, dst + i, n - i, lo, hi);
+}
+
+static void toInt16Neon(const float *src, qint16 *dst, qint64 n, float scale)
+{
+    const float32x4_t vlo = vdupq_n_f32(-32768.0f), vhi = vdupq_n_f32(32767.0f);
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), scale), vlo), vhi);
+        const float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), scale), vlo), vhi);
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+    }
+    toInt16Scalar(src + i, dst + i, n - i, scale);
+}
+
+static void toInt32Neon(const float *src, qint32 *dst, qint64 n, float scale, float lo, float hi)
+{
+    const float32x4_t vlo = vdupq_n_f32(lo), vhi = vdupq_n_f32(hi);
+    qint64 i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), scale), vlo), vhi);
+        vst1q_s32(dst + i, vcvtnq_s32_f32(a));
+    }
+    toInt32Scalar(src + i, dst + i, n - i, scale, lo, hi);
+}
+
+static void int16ToFloatNeon(const qint16 *src, float *dst, qint64 n)
+{
+    const float scale = 1.0f / 32768.0f;
+    qint64 i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(src + i);
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    int16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+static void deinterleaveFloatNeon(const float *src, int channels, qint64 frames, float *const *dst)
+{
+    if (channels == 1) {
+        std::memcpy(dst[0], src, frames * sizeof(float));
+        return;
+    }
+    qint64 i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4x2_t v = vld2q_f32(src + 2 * i);
+            vst1q_f32(dst[0] + i, v.val[0]);
+            vst1q_f32(dst[1] + i, v.val[1]);
+        }
+    }
+    deinterleaveScalar(src, channels, i, frames, dst, 1.0f, 0.0f);
+}
+
+static void deinterleaveInt16Neon(const qint16 *src, int channels, qint64 frames, float *const *dst)
+{
+    if (channels == 1) {
+        int16ToFloatNeon(src, dst[0], frames);
+        return;
+    }
+    const float scale = 1.0f / 32768.0f;
+    qint64 i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            const int16x8x2_t v = vld2q_s16(src + 2 * i);
+            for (int c = 0; c < 2; ++c) {
+                vst1q_f32(dst[c] + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[c]))), scale));
+                vst1q_f32(dst[c] + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[c]))), scale));
+            }
+        }
+    }
+    deinterleaveScalar(src, channels, i, frames, dst, scale, 0.0f);
+}
+
+static void deinterleaveInt32Neon(const qint32 *src, int channels, qint64 frames, float *const *dst)
+{
+    const float scale = 1.0f / 2147483648.0f;
+    qint64 i = 0;
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4)
+            vst1q_f32(dst[0] + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+    } else if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const int32x4x2_t v = vld2q_s32(src + 2 * i);
+            vst1q_f32(dst[0] + i, vmulq_n_f32(vcvtq_f32_s32(v.val[0]), scale));
+            vst1q_f32(dst[1] + i, vmulq_n_f32(vcvtq_f32_s32(v.val[1]), scale));
+        }
+    }
+    deinterleaveScalar(src, channels, i, frames, dst, scale, 0.0f);
+}
+
+static void downmixNeon(const float *src, int srcChannels, float *dst, int dstChannels, qint64 frames)
+{
+    qint64 i = 0;
+    if (srcChannels == 2 && dstChannels == 1) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4x2_t v = vld2q_f32(src + 2 * i);
+            vst1q_f32(dst + i, vmulq_n_f32(vaddq_f32(v.val[0], v.val[1]), 0.5f));
+        }
+    } else if (srcChannels == 1 && dstChannels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4_t v = vld1q_f32(src + i);
+            vst2q_f32(dst + 2 * i, float32x4x2_t{{v, v}});
+        }
+    }
+    downmixScalar(src, srcChannels, dst, dstChannels, i, frames);
+}
+
+#endif // DSP_NEON
+
+// ============================================================================
+// CHOIX DE LA VARIANTE
+// ============================================================================
+
+namespace {
+struct KernelTable {
+    const char *name;
+    float (*absMax)(const float *, qint64);
+    void (*minMax)(const float *, qint64, float &, float &);
+    double (*sumSquares)(const float *, qint64);
+    void (*scale)(const float *, float *, qint64, float);
+    void (*clamp)(const float *, float *, qint64, float, float);
+    void (*toInt16)(const float *, qint16 *, qint64, float);
+    void (*toInt32)(const float *, qint32 *, qint64, float, float, float);
+    void (*int16ToFloat)(const qint16 *, float *, qint64);
+    void (*deinterleaveFloat)(const float *, int, qint64, float *const *);
+    void (*deinterleaveInt16)(const qint16 *, int, qint64, float *const *);
+    void (*deinterleaveInt32)(const qint32 *, int, qint64, float *const *);
+    void (*downmix)(const float *, int, float *, int, qint64);
+};
+}
+
+// Table d'une variante donnée ; false si elle n'est pas compilée ou si le
+// processeur ne la prend pas en charge
+static bool kernelTable(const char *name, KernelTable &table)
+{
+#if defined(DSP_AVX2)
+    // La répartition des canaux est limitée par la mémoire : SSE2 suffit
+    if (std::strcmp(name, "avx2") == 0) {
+        if (!cpuHasAvx2()) return false;
+        table = { "avx2", absMaxAvx2, minMaxAvx2, sumSquaresAvx2, scaleAvx2, clampAvx2, toInt16Avx2, toInt32Avx2,
+                  int16ToFloatAvx2, deinterleaveFloatSse2, deinterleaveInt16Sse2, deinterleaveInt32Sse2,
+                  downmixSse2 };
+        return true;
+    }
+#endif
+#if defined(DSP_SSE2)
+    if (std::strcmp(name, "sse2") == 0) {
+        table = { "sse2", absMaxSse2, minMaxSse2, sumSquaresSse2, scaleSse2, clampSse2, toInt16Sse2, toInt32Sse2,
+                  int16ToFloatSse2, deinterleaveFloatSse2, deinterleaveInt16Sse2, deinterleaveInt32Sse2,
+                  downmixSse2 };
+        return true;
+    }
+#endif
+#if defined(DSP_NEON)
+    if (std::strcmp(name, "neon") == 0) {
+        table = { "neon", absMaxNeon, minMaxNeon, sumSquaresNeon, scaleNeon, clampNeon, toInt16Neon, toInt32Neon,
+                  int16ToFloatNeon, deinterleaveFloatNeon, deinterleaveInt16Neon, deinterleaveInt32Neon,
+                  downmixNeon };
+        return true;
+    }
+#endif
+    if (std::strcmp(name, "scalar") == 0) {
+        table = { "scalar", absMaxScalar, minMaxScalar, sumSquaresScalar, scaleScalar, clampScalar, toInt16Scalar,
+                  toInt32Scalar, int16ToFloatScalar, deinterleaveFloatScalar, deinterleaveInt16Scalar,
+                  deinterleaveInt32Scalar, downmixAllScalar };
+        return true;
+    }
+    return false;
+}
+
+// La meilleure variante disponible
+static KernelTable selectKernels()
+{
+    KernelTable table;
+    for (const char *name : { "avx2", "sse2", "neon" }) {
+        if (kernelTable(name, table))
+            return table;
+    }
+    kernelTable("scalar", table);
+    return table;
+}
+
+// Détection faite une seule fois (initialisation statique sûre entre threads)
+static KernelTable &kernels()
+{
+    static KernelTable table = selectKernels();
+    return table;
+}
+
+// ============================================================================
+// POINTS D'ENTRÉE
+// ============================================================================
+
+namespace DspKernels
+{
+
+const char *isaName()
+{
+    return kernels().name;
+}
+
+bool setIsa(const char *name)
+{
+    KernelTable table;
+    if (!kernelTable(name, table))
+        return false;
+    kernels() = table;
+    return true;
+}
+
+float absMax(const float *src, qint64 n)
+{
+    return n > 0 ? kernels().absMax(src, n) : 0.0f;
+}
+
+void minMax(const float *src, qint64 n, float &mn, float &mx)
+{
+    if (n > 0) kernels().minMax(src, n, mn, mx);
+}
+
+double sumSquares(const float *src, qint64 n)
+{
+    return n > 0 ? kernels().sumSquares(src, n) : 0.0;
+}
+
+void scale(const float *src, float *dst, qint64 n, float gain)
+{
+    if (n > 0) kernels().scale(src, dst, n, gain);
+}
+
+void clamp(const float *src, float *dst, qint64 n, float lo, float hi)
+{
+    if (n > 0) kernels().clamp(src, dst, n, lo, hi);
+}
+
+void floatToInt16(const float *src, qint16 *dst, qint64 n, float scale)
+{
+    if (n > 0) kernels().toInt16(src, dst, n, scale);
+}
+
+void floatToInt24(const float *src, uchar *dst, qint64 n, float scale)
+{
+    // Conversion en int32 par petits paquets, puis resserrement en 3 octets
+    float lo, hi;
+    intRange(24, lo, hi);
+    qint32 tmp[1024];
+    for (qint64 done = 0; done < n; ) {
+        const qint64 m = std::min<qint64>(1024, n - done);
+        kernels().toInt32(src + done, tmp, m, scale, lo, hi);
+        for (qint64 i = 0; i < m; ++i) {
+            dst[0] = uchar(tmp[i]);
+            dst[1] = uchar(tmp[i] >> 8);
+            dst[2] = uchar(tmp[i] >> 16);
+            dst += 3;
+        }
+        done += m;
+    }
+}
+
+void floatToInt32(const float *src, qint32 *dst, qint64 n, float scale, int bits)
+{
+    float lo, hi;
+    intRange(bits, lo, hi);
+    if (n > 0) kernels().toInt32(src, dst, n, scale, lo, hi);
+}
+
+void int16ToFloat(const qint16 *src, float *dst, qint64 n)
+{
+    if (n > 0) kernels().int16ToFloat(src, dst, n);
+}
+
+void int24ToFloat(const uchar *src, float *dst, qint64 n)
+{
+    // 3 octets sans alignement : une boucle simple, que le compilateur vectorise
+    const float scale = 1.0f / 8388608.0f;
+    for (qint64 i = 0; i < n; ++i) {
+        // Octets placés en haut d'un int32, puis décalage arithmétique (signe)
+        const qint32 v = qint32(quint32(src[0]) << 8 | quint32(src[1]) << 16 | quint32(src[2]) << 24) >> 8;
+        dst[i] = v * scale;
+        src += 3;
+    }
+}
+
+void deinterleave(const float *src, int channels, qint64 frames, float *const *dst)
+{
+    if (frames > 0 && channels > 0) kernels().deinterleaveFloat(src, channels, frames, dst);
+}
+
+void deinterleave(const qint16 *src, int channels, qint64 frames, float *const *dst)
+{
+    if (frames > 0 && channels > 0) kernels().deinterleaveInt16(src, channels, frames, dst);
+}
+
+void deinterleave(const qint32 *src, int channels, qint64 frames, float *const *dst)
+{
+    if (frames > 0 && channels > 0) kernels().deinterleaveInt32(src, channels, frames, dst);
+}
+
+void deinterleave(const quint8 *src, int channels, qint64 frames, float *const *dst)
+{
+    // 8 bits non signé : le silence vaut 128
+    if (frames > 0 && channels > 0) deinterleaveScalar(src, channels, 0, frames, dst, 1.0f / 128.0f, 128.0f);
+}
+
+void downmix(const float *src, int srcChannels, float *dst, int dstChannels, qint64 frames)
+{
+    if (frames > 0 && srcChannels > 0 && dstChannels > 0)
+        kernels().downmix(src, srcChannels, dst, dstChannels, frames);
+}
+
+}
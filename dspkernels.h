@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Noyaux de calcul des boucles critiques de l'éditeur (pics, gain,
+// conversions PCM, valeur efficace, répartition et mixage des canaux).
+// Chaque noyau existe en plusieurs variantes : AVX2 et SSE2 sur x86, NEON sur
+// ARM64, et une version scalaire. La variante x86 est choisie au premier
+// appel selon le processeur : le même exécutable profite d'AVX2 là où il est
+// disponible, sans l'exiger ailleurs. Toutes les variantes donnent les mêmes
+// résultats (arrondi au plus proche pour les conversions en entier).
+namespace DspKernels
+{
+// Variante retenue : "avx2", "sse2", "neon" ou "scalar"
+const char *isaName();
+// Pour les tests et les mesures : impose la variante name ("avx2", "sse2",
+// "neon" ou "scalar"). Renvoie false si elle n'est pas disponible ici.
+// À n'appeler que lorsqu'aucun calcul n'est en cours.
+bool setIsa(const char *name);
+
+float absMax(const float *src, qint64 n);
+// Élargit [mn, mx] aux valeurs de src (les bornes existantes sont conservées)
+void minMax(const float *src, qint64 n, float &mn, float &mx);
+// Somme des x² en double, pour la valeur efficace (RMS) ; le résultat est
+// le même, au bit près, quelle que soit la variante
+double sumSquares(const float *src, qint64 n);
+// dst[i] = src[i] * gain ; dst peut être src
+void scale(const float *src, float *dst, qint64 n, float gain);
+// dst[i] = src[i] borné à [lo, hi] ; dst peut être src
+void clamp(const float *src, float *dst, qint64 n, float lo, float hi);
+
+// Quantification : round(x * scale), borné à l'entier signé de bits bits
+// (16, 24 ou 32). En 24 bits, 3 octets little-endian par échantillon.
+void floatToInt16(const float *src, qint16 *dst, qint64 n, float scale = 32768.0f);
+void floatToInt24(const float *src, uchar *dst, qint64 n, float scale = 8388608.0f);
+void floatToInt32(const float *src, qint32 *dst, qint64 n, float scale, int bits);
+// Inverse : x / 2^(bits-1)
+void int16ToFloat(const qint16 *src, float *dst, qint64 n);
+void int24ToFloat(const uchar *src, float *dst, qint64 n);
+
+// Trames entrelacées -> un tableau par canal (dst[c][0..frames)),
+// mis à l'échelle [-1, 1] ; l'UInt8 est centré sur 128
+void deinterleave(const float *src, int channels, qint64 frames, float *const *dst);
+void deinterleave(const qint16 *src, int channels, qint64 frames, float *const *dst);
+void deinterleave(const qint32 *src, int channels, qint64 frames, float *const *dst);
+void deinterleave(const quint8 *src, int channels, qint64 frames, float *const *dst);
+
+// Change le nombre de canaux de trames entrelacées : le canal de sortie c est
+// la moyenne des canaux source s ≡ c (mod dstChannels), ou la copie du canal
+// c % srcChannels si la sortie a plus de canaux (mono -> stéréo)
+void downmix(const float *src, int srcChannels, float *dst, int dstChannels, qint64 frames);
+}
@@ -0,0 +1,59 @@
+#include "edithistory.h"
+
+#include <QSet>
+
+void EditHistory::clear()
+{
+    undoStack.clear();
+    redoStack.clear();
+}
+
+void EditHistory::setMemoryBudget(qint64 bytes)
+{
+    budget = qMax<qint64>(0, bytes);
+}
+
+void EditHistory::push(const State &before, const MultiChannelBuffer &current)
+{
+    undoStack.append(before);
+    redoStack.clear();
+    enforceBudget(current);
+}
+
+EditHistory::State EditHistory::undo(const State &current)
+{
+    if (undoStack.isEmpty()) return current;
+    State previous = undoStack.takeLast();
+    redoStack.append(current);
+    return previous;
+}
+
+EditHistory::State EditHistory::redo(const State &current)
+{
+    if (redoStack.isEmpty()) return current;
+    State next = redoStack.takeLast();
+    undoStack.append(current);
+    return next;
+}
+
+qint64 EditHistory::memoryUsage(const MultiChannelBuffer &current) const
+{
+    // Les blocs du signal courant sont de toute façon en mémoire : on ne compte pas
+    QSet<const SampleBlock *> seen;
+    current.blockBytes(seen);
+
+    qint64 bytes = 0;
+    for (const State &state : undoStack) bytes += state.samples.blockBytes(seen);
+    for (const State &state : redoStack) bytes += state.samples.blockBytes(seen);
+    return bytes;
+}
+
+void EditHistory::enforceBudget(const MultiChannelBuffer &current)
+{
+    while (undoStack.size() > MAX_DEPTH)
+        undoStack.removeFirst();
+
+    // On oublie d'abord les annulations les plus anciennes
+    while (!undoStack.isEmpty() && memoryUsage(current) > budget)
+        undoStack.removeFirst();
+}
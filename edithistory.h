@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include "samplebuffer.h"
+
+// Historique annuler / rétablir de l'éditeur.
+// Chaque entrée garde une copie du signal, c'est-à-dire une simple liste de
+// morceaux par canal sur des blocs partagés : annuler une coupe ne recopie
+// aucun échantillon. Seuls les blocs que plus aucune version courante n'utilise
+// (ex. la plage d'origine d'une normalisation) coûtent de la mémoire ; ce
+// surcoût est borné par un budget, au-delà duquel les entrées les plus
+// anciennes sont oubliées.
+class EditHistory
+{
+public:
+    struct State {
+        MultiChannelBuffer samples;
+        qint64 selectionStart = -1;
+        qint64 selectionEnd = -1;
+        QString label;          // Nom de l'action, pour les infobulles
+    };
+
+    static const int MAX_DEPTH = 100;
+
+    void clear();
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return budget; }
+
+    // À appeler juste après une modification : before est l'état d'avant,
+    // current le signal modifié (sert au calcul du budget mémoire)
+    void push(const State &before, const MultiChannelBuffer &current);
+
+    bool canUndo() const { return !undoStack.isEmpty(); }
+    bool canRedo() const { return !redoStack.isEmpty(); }
+    QString undoLabel() const { return canUndo() ? undoStack.last().label : QString(); }
+    QString redoLabel() const { return canRedo() ? redoStack.last().label : QString(); }
+
+    // Renvoient l'état à restaurer ; current part dans la pile opposée
+    State undo(const State &current);
+    State redo(const State &current);
+
+    // Mémoire retenue par l'historique seul (blocs absents du signal courant)
+    qint64 memoryUsage(const MultiChannelBuffer &current) const;
+
+private:
+    void enforceBudget(const MultiChannelBuffer &current);
+
+    QVector<State> undoStack;
+    QVector<State> redoStack;
+    qint64 budget = qint64(1024) * 1024 * 1024;
+};
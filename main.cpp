@@ -5,6 +5,8 @@
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
 
+    // Emplacement de la configuration (QSettings) et des caches
+    app.setOrganizationName("Son Fusion");
     app.setApplicationName("Son Fusion");
     app.setApplicationVersion("2.22");
 
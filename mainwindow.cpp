@@ -45,6 +45,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     connect(audioMerger, &AudioMerger::started, this, &MainWindow::onMergeStarted);
     connect(audioMerger, &AudioMerger::finished, this, &MainWindow::onMergeFinished);
     connect(audioMerger, &AudioMerger::error, this, &MainWindow::showError);
+    connect(audioMerger, &AudioMerger::progress, this, &MainWindow::onMergeProgress);
 
     connect(audioMerger, &AudioMerger::statusMessage, this, [this](const QString& msg) {
         statusBar()->showMessage(msg);
@@ -285,6 +286,13 @@ void MainWindow::createUI() {
     // Utiliser la barre d'état existante
     statusBar()->showMessage("Prêt");
     statusBar()->setStyleSheet("background-color: " + STATUS_BAR_COLOR + "; color: white;");
+
+    // Avancement de la fusion, visible seulement pendant une fusion
+    mergeProgressBar = new QProgressBar(this);
+    mergeProgressBar->setMaximumWidth(150);
+    mergeProgressBar->setTextVisible(false);
+    mergeProgressBar->setVisible(false);
+    statusBar()->addPermanentWidget(mergeProgressBar);
 }
 
 // Gestion de l'enregistrement Audio
@@ -541,12 +549,21 @@ void MainWindow::onMergeStarted() {
     // 2. Désactiver l'interface pour éviter les double-clics    
     centralWidget()->setEnabled(false); 
     statusBar()->showMessage("Fusion en cours...");
+    mergeProgressBar->setRange(0, 0);   // Indéterminé tant que la durée n'est pas connue
+    mergeProgressBar->setVisible(true);
+}
+
+void MainWindow::onMergeProgress(const MergeProgress& progress) {
+    if (progress.fraction < 0.0) return;
+    mergeProgressBar->setRange(0, 1000);
+    mergeProgressBar->setValue(int(progress.fraction * 1000));
 }
 
 void MainWindow::onMergeFinished(bool success) {
     QApplication::restoreOverrideCursor();
     // 2. Réactiver l'interface
     centralWidget()->setEnabled(true);
+    mergeProgressBar->setVisible(false);
     statusBar()->clearMessage();
 
     if (success) {
@@ -565,6 +582,7 @@ void MainWindow::showError(const QString& message) {
     // IMPORTANT : Rétablir le curseur aussi en cas d'erreur !
     QApplication::restoreOverrideCursor();
     centralWidget()->setEnabled(true);
+    mergeProgressBar->setVisible(false);
 
     statusBar()->showMessage("Erreur lors de la fusion.");
     QMessageBox::critical(this, "Erreur", message);
@@ -9,8 +9,10 @@
 #include <QComboBox>
 #include <QMediaPlayer>
 #include <QAudioOutput>
+#include <QProgressBar>
 
 class AudioMerger;
+struct MergeProgress;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -32,6 +34,7 @@ private slots:
     void mergeFiles();
     void onMergeStarted();
     void onMergeFinished(bool success);
+    void onMergeProgress(const MergeProgress& progress);
     void showError(const QString& message);
     void showInfo();
     void onPlaybackStateChanged(QMediaPlayer::PlaybackState state);
@@ -67,6 +70,7 @@ private:
     QPushButton* downButton;
 
     AudioMerger* audioMerger;
+    QProgressBar* mergeProgressBar;
     QMediaPlayer* mediaPlayer;
     QAudioOutput* audioOutput;
     QPushButton* recordButton;
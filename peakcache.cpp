@@ -0,0 +1,144 @@
+#include "peakcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static const quint32 PEAK_CACHE_MAGIC = 0x5346504B; // "SFPK"
+static const quint32 PEAK_CACHE_VERSION = 3;     // 2 : une pyramide par canal, 3 : énergie (RMS)
+static const int PEAK_CACHE_MAX_FILES = 200;
+// Taille totale du cache : une entrée de plusieurs heures pèse des dizaines de Mo
+static const qint64 PEAK_CACHE_MAX_BYTES = qint64(512) << 20;
+
+// Clé d'un fichier audio : chemin absolu + taille + date de modification
+static QByteArray fileKey(const QFileInfo &fi)
+{
+    return fi.absoluteFilePath().toUtf8() + '|'
+         + QByteArray::number(fi.size()) + '|'
+         + QByteArray::number(fi.lastModified().toMSecsSinceEpoch());
+}
+
+QString PeakCache::cacheFilePath(const QString &audioFile)
+{
+    QFileInfo fi(audioFile);
+    if (!fi.exists()) return QString();
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/peaks";
+    QByteArray hash = QCryptographicHash::hash(fileKey(fi), QCryptographicHash::Sha1).toHex();
+    return dir + "/" + QString::fromLatin1(hash) + ".peaks";
+}
+
+bool PeakCache::load(const QString &audioFile, Entry &entry)
+{
+    QString path = cacheFilePath(audioFile);
+    if (path.isEmpty()) return false;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&f);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0, version = 0;
+    QByteArray key;
+    qint32 sampleRate = 0, channelCount = 0, levelCount = 0;
+    qint64 sampleCount = 0;
+    in >> magic >> version >> key >> sampleRate >> channelCount >> sampleCount >> levelCount;
+
+    // Collision de hash ou fichier d'une autre version : on ignore l'entrée
+    if (in.status() != QDataStream::Ok || magic != PEAK_CACHE_MAGIC || version != PEAK_CACHE_VERSION
+        || key != fileKey(QFileInfo(audioFile)) || levelCount != PeakPyramid::LEVEL_COUNT
+        || sampleRate <= 0 || channelCount <= 0 || channelCount > 64 || sampleCount <= 0) {
+        return false;
+    }
+    // Entrée tronquée ou corrompue : le niveau 0 seul (un pic pour 256
+    // échantillons, par canal) ne tiendrait pas dans le fichier. Vérifié avant
+    // toute allocation, pour qu'une mauvaise entrée ne soit qu'un défaut de cache.
+    const qint64 peakBytes = qint64(sizeof(PeakPyramid::Peak)) * channelCount;
+    if (sampleCount / PeakPyramid::BASE_BLOCK > f.size() / peakBytes) return false;
+
+    QVector<PeakPyramid> peaks(channelCount);
+    for (PeakPyramid &channel : peaks) {
+        QVector<QVector<PeakPyramid::Peak>> levels(levelCount);
+        for (int level = 0; level < levelCount; ++level) {
+            qint64 n = 0;
+            in >> n;
+            // Un pic par bloc entamé : la longueur de chaque niveau est connue d'avance
+            const qint64 blockSize = PeakPyramid::blockSize(level);
+            if (in.status() != QDataStream::Ok || n != (sampleCount + blockSize - 1) / blockSize) return false;
+            levels[level].resize(n);
+            const qint64 bytes = n * qint64(sizeof(PeakPyramid::Peak));
+            // QDataStream ne bufferise pas : on lit le bloc directement sur le fichier
+            if (f.read(reinterpret_cast<char*>(levels[level].data()), bytes) != bytes) return false;
+        }
+        if (!channel.restore(sampleCount, levels)) return false;
+    }
+
+    entry.sampleRate = sampleRate;
+    entry.peaks = peaks;
+
+    // Date de l'entrée = dernière utilisation : prune() évince les moins récemment lues.
+    // Ouverture en ajout (contenu inchangé) : la date ne se règle pas en lecture seule sous Windows
+    f.close();
+    QFile touch(path);
+    if (touch.open(QIODevice::Append))
+        touch.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    return true;
+}
+
+bool PeakCache::save(const QString &audioFile, const Entry &entry)
+{
+    QString path = cacheFilePath(audioFile);
+    if (path.isEmpty() || entry.peaks.isEmpty() || entry.peaks[0].sampleCount() <= 0) return false;
+
+    QString dir = QFileInfo(path).absolutePath();
+    if (!QDir().mkpath(dir)) return false;
+
+    // QSaveFile : une entrée à moitié écrite n'est jamais visible
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&f);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << PEAK_CACHE_MAGIC << PEAK_CACHE_VERSION << fileKey(QFileInfo(audioFile))
+        << qint32(entry.sampleRate) << qint32(entry.peaks.size())
+        << qint64(entry.peaks[0].sampleCount()) << qint32(PeakPyramid::LEVEL_COUNT);
+
+    // Les pics sont écrits tels quels (ordre des octets de la machine : cache local),
+    // canal après canal
+    for (const PeakPyramid &channel : entry.peaks) {
+        for (int level = 0; level < PeakPyramid::LEVEL_COUNT; ++level) {
+            const QVector<PeakPyramid::Peak> &peaks = channel.level(level);
+            const qint64 bytes = peaks.size() * qint64(sizeof(PeakPyramid::Peak));
+            out << qint64(peaks.size());
+            if (f.write(reinterpret_cast<const char*>(peaks.constData()), bytes) != bytes) {
+                f.cancelWriting();
+                return false;
+            }
+        }
+    }
+
+    if (out.status() != QDataStream::Ok || !f.commit()) return false;
+
+    prune(dir);
+    return true;
+}
+
+// Garde le cache borné en nombre d'entrées et en octets : on supprime les
+// entrées utilisées le moins récemment (load() rafraîchit leur date)
+void PeakCache::prune(const QString &cacheDir)
+{
+    QDir dir(cacheDir);
+    QFileInfoList files = dir.entryInfoList({"*.peaks"}, QDir::Files, QDir::Time);
+    qint64 totalBytes = 0;
+    for (int i = 0; i < files.size(); ++i) {
+        totalBytes += files[i].size();
+        if (i >= PEAK_CACHE_MAX_FILES || totalBytes > PEAK_CACHE_MAX_BYTES)
+            QFile::remove(files[i].absoluteFilePath());
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QString>
+#include "peakpyramid.h"
+
+// Cache disque des pics de forme d'onde ("sidecar"), rangé dans le dossier
+// cache de l'utilisateur. Une entrée est identifiée par le chemin, la taille
+// et la date de modification du fichier audio : toute modification du
+// fichier invalide donc automatiquement son entrée.
+// Les fonctions ne touchent qu'au disque : elles peuvent tourner hors du
+// thread de l'interface (QtConcurrent).
+class PeakCache
+{
+public:
+    struct Entry {
+        int sampleRate = 0;
+        // Une pyramide par canal ; sampleCount() = longueur du signal décodé
+        QVector<PeakPyramid> peaks;
+    };
+
+    static bool load(const QString &audioFile, Entry &entry);
+    static bool save(const QString &audioFile, const Entry &entry);
+
+private:
+    static QString cacheFilePath(const QString &audioFile);
+    static void prune(const QString &cacheDir);
+};
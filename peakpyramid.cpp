@@ -0,0 +1,293 @@
+#include "peakpyramid.h"
+#include "dspkernels.h"
+#include "samplebuffer.h"
+
+#include <algorithm>
+#include <limits>
+
+void PeakPyramid::clear()
+{
+    for (QVector<Peak> &level : levels) level.clear();
+    count = 0;
+}
+
+qint64 PeakPyramid::blockSize(int level)
+{
+    qint64 size = BASE_BLOCK;
+    for (int i = 0; i < level; ++i) size *= LEVEL_RATIO;
+    return size;
+}
+
+void PeakPyramid::build(const SampleBuffer &samples)
+{
+    clear();
+    if (samples.isEmpty()) return;
+    for (int level = 0; level < LEVEL_COUNT; ++level)
+        levels[level].reserve(samples.size() / blockSize(level) + 1);
+    samples.forEachSpan(0, samples.size(), [this](const float *data, qint64 n) {
+        append(data, n);
+    });
+}
+
+bool PeakPyramid::restore(qint64 sampleCount, const QVector<QVector<Peak>> &data)
+{
+    clear();
+    if (sampleCount <= 0 || data.size() != LEVEL_COUNT) return false;
+
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        const qint64 b = blockSize(level);
+        if (data[level].size() != (sampleCount + b - 1) / b) {
+            clear();
+            return false;
+        }
+        levels[level] = data[level];
+    }
+    count = sampleCount;
+    return true;
+}
+
+void PeakPyramid::append(const float *samples, qint64 n)
+{
+    if (!samples || n <= 0) return;
+
+    // 1. Niveau 0 : min/max et somme des carrés de chaque bloc de 256 échantillons.
+    // Le premier bloc peut être un bloc partiel laissé par l'ajout précédent.
+    QVector<Peak> &base = levels[0];
+    qint64 firstDirty = count / BASE_BLOCK;
+    qint64 i = 0;
+    while (i < n) {
+        const qint64 pos = count + i;
+        const qint64 block = pos / BASE_BLOCK;
+        const qint64 runEnd = std::min(n, i + (BASE_BLOCK - pos % BASE_BLOCK));
+
+        float mn = samples[i];
+        float mx = samples[i];
+        DspKernels::minMax(samples + i + 1, runEnd - i - 1, mn, mx);
+        const double energy = DspKernels::sumSquares(samples + i, runEnd - i);
+
+        if (block < base.size()) {
+            base[block].min = std::min(base[block].min, mn);
+            base[block].max = std::max(base[block].max, mx);
+            base[block].energy += energy;
+        } else {
+            base.append(Peak{mn, mx, energy});
+        }
+        i = runEnd;
+    }
+    count += n;
+
+    // 2. Niveaux supérieurs : on ne refait que les pics couvrant les nouveaux blocs
+    for (int level = 1; level < LEVEL_COUNT; ++level) {
+        const QVector<Peak> &finer = levels[level - 1];
+        QVector<Peak> &coarse = levels[level];
+        firstDirty /= LEVEL_RATIO;
+
+        const qint64 needed = (finer.size() + LEVEL_RATIO - 1) / LEVEL_RATIO;
+        coarse.resize(needed);
+        for (qint64 e = firstDirty; e < needed; ++e) {
+            const qint64 from = e * LEVEL_RATIO;
+            const qint64 to = std::min<qint64>(finer.size(), from + LEVEL_RATIO);
+            Peak p = finer[from];
+            for (qint64 k = from + 1; k < to; ++k) {
+                p.min = std::min(p.min, finer[k].min);
+                p.max = std::max(p.max, finer[k].max);
+                p.energy += finer[k].energy;
+            }
+            coarse[e] = p;
+        }
+    }
+}
+
+PeakPyramid::Peak PeakPyramid::peakRange(const SampleBuffer *samples, qint64 start, qint64 end, qint64 origin,
+                                         bool *ok) const
+{
+    start = std::max<qint64>(0, start);
+    end = std::min(end, count);
+    if (start >= end) return Peak();
+
+    // On part du niveau le plus grossier dont un bloc tient dans la plage
+    int level = LEVEL_COUNT - 1;
+    while (level >= 0 && blockSize(level) > end - start) --level;
+
+    Peak acc{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+    bool read = true;
+    accumulate(level, samples, origin, start, end, acc, read);
+    if (ok && !read) *ok = false;
+    if (acc.min > acc.max) return Peak();
+    return acc;
+}
+
+void PeakPyramid::accumulate(int level, const SampleBuffer *samples, qint64 origin, qint64 start, qint64 end,
+                             Peak &acc, bool &ok) const
+{
+    if (start >= end) return;
+
+    // Sous le niveau 0 : on lit les échantillons bruts (au plus 2 x 255 par plage)
+    if (level < 0) {
+        if (!samples) {
+            // Pas de signal brut (aperçu issu du cache) : blocs du niveau 0 qui touchent la plage
+            const QVector<Peak> &base = levels[0];
+            const qint64 stop = std::min<qint64>((end - 1) / BASE_BLOCK + 1, base.size());
+            for (qint64 e = start / BASE_BLOCK; e < stop; ++e) {
+                acc.min = std::min(acc.min, base[e].min);
+                acc.max = std::max(acc.max, base[e].max);
+                const qint64 blockStart = e * BASE_BLOCK;
+                const qint64 blockEnd = std::min(blockStart + BASE_BLOCK, count);
+                const qint64 covered = std::min(end, blockEnd) - std::max(start, blockStart);
+                acc.energy += base[e].energy * covered / (blockEnd - blockStart);
+            }
+            return;
+        }
+        ok &= samples->forEachSpan(origin + start, origin + end, [&acc](const float *data, qint64 n) {
+            DspKernels::minMax(data, n, acc.min, acc.max);
+            acc.energy += DspKernels::sumSquares(data, n);
+        });
+        return;
+    }
+
+    const qint64 b = blockSize(level);
+    const qint64 firstFull = (start + b - 1) / b;
+    const qint64 lastFull = end / b;
+    if (firstFull >= lastFull) {
+        accumulate(level - 1, samples, origin, start, end, acc, ok);
+        return;
+    }
+
+    // Bord gauche, blocs complets de ce niveau, bord droit
+    accumulate(level - 1, samples, origin, start, firstFull * b, acc, ok);
+    const QVector<Peak> &entries = levels[level];
+    const qint64 stop = std::min<qint64>(lastFull, entries.size());
+    for (qint64 e = firstFull; e < stop; ++e) {
+        acc.min = std::min(acc.min, entries[e].min);
+        acc.max = std::max(acc.max, entries[e].max);
+        acc.energy += entries[e].energy;
+    }
+    accumulate(level - 1, samples, origin, lastFull * b, end, acc, ok);
+}
+
+// ============================================================================
+// PEAKTRACK
+// ============================================================================
+
+void PeakTrack::clear()
+{
+    segments.clear();
+    segmentStarts.clear();
+    total = 0;
+}
+
+void PeakTrack::build(const SampleBuffer &samples)
+{
+    clear();
+    if (samples.isEmpty()) return;
+    Segment seg;
+    seg.pyramid = QSharedPointer<PeakPyramid>::create();
+    seg.pyramid->build(samples);
+    seg.length = seg.pyramid->sampleCount();
+    segments.append(seg);
+    segmentStarts.append(0);
+    total = seg.length;
+}
+
+void PeakTrack::append(const float *samples, qint64 count)
+{
+    if (!samples || count <= 0) return;
+
+    // La dernière pyramide grandit si notre dernière plage va jusqu'à sa fin
+    if (segments.isEmpty() || segments.last().offset + segments.last().length != segments.last().pyramid->sampleCount()) {
+        Segment seg;
+        seg.pyramid = QSharedPointer<PeakPyramid>::create();
+        segments.append(seg);
+        segmentStarts.append(total);
+    }
+    Segment &last = segments.last();
+    last.pyramid->append(samples, count);
+    last.length += count;
+    total += count;
+}
+
+int PeakTrack::findSegment(qint64 pos) const
+{
+    auto it = std::upper_bound(segmentStarts.constBegin(), segmentStarts.constEnd(), pos);
+    return std::max(0, int(it - segmentStarts.constBegin()) - 1);
+}
+
+void PeakTrack::rebuildIndex(int from)
+{
+    segmentStarts.resize(segments.size());
+    for (int i = std::max(0, from); i < segments.size(); ++i)
+        segmentStarts[i] = (i == 0) ? 0 : segmentStarts[i - 1] + segments[i - 1].length;
+}
+
+int PeakTrack::splitAt(qint64 pos)
+{
+    if (pos >= total) return segments.size();
+    if (pos <= 0) return 0;
+
+    const int i = findSegment(pos);
+    const qint64 cut = pos - segmentStarts[i];
+    if (cut == 0) return i;
+
+    Segment right = segments[i];
+    right.offset += cut;
+    right.length -= cut;
+    segments[i].length = cut;
+    segments.insert(i + 1, right);
+    segmentStarts.insert(i + 1, pos);
+    return i + 1;
+}
+
+void PeakTrack::replace(const SampleBuffer &samples, qint64 start, qint64 removed, qint64 inserted)
+{
+    start = std::clamp<qint64>(start, 0, total);
+    removed = std::clamp<qint64>(removed, 0, total - start);
+
+    const int first = splitAt(start);
+    const int last = splitAt(start + removed);
+    segments.remove(first, last - first);
+
+    // Seule la plage nouvelle est lue et résumée
+    if (inserted > 0) {
+        Segment seg;
+        seg.pyramid = QSharedPointer<PeakPyramid>::create();
+        samples.forEachSpan(start, start + inserted, [&seg](const float *data, qint64 n) {
+            seg.pyramid->append(data, n);
+        });
+        seg.length = seg.pyramid->sampleCount();
+        segments.insert(first, seg);
+        inserted = seg.length;
+    }
+    total += inserted - removed;
+    rebuildIndex(first);
+}
+
+PeakPyramid::Peak PeakTrack::peakRange(const SampleBuffer *samples, qint64 start, qint64 end, bool *ok) const
+{
+    start = std::max<qint64>(0, start);
+    end = std::min(end, total);
+    if (start >= end) return PeakPyramid::Peak();
+
+    PeakPyramid::Peak acc{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+    for (int i = findSegment(start); i < segments.size() && segmentStarts[i] < end; ++i) {
+        const Segment &seg = segments[i];
+        const qint64 segStart = segmentStarts[i];
+        const qint64 from = std::max(start, segStart) - segStart + seg.offset;
+        const qint64 to = std::min(end, segStart + seg.length) - segStart + seg.offset;
+        if (from >= to) continue;
+        // Les échantillons bruts de la pyramide sont à segStart - offset dans le signal
+        const PeakPyramid::Peak p = seg.pyramid->peakRange(samples, from, to, segStart - seg.offset, ok);
+        acc.min = std::min(acc.min, p.min);
+        acc.max = std::max(acc.max, p.max);
+        acc.energy += p.energy;
+    }
+    if (acc.min > acc.max) return PeakPyramid::Peak();
+    return acc;
+}
+
+const PeakPyramid *PeakTrack::wholePyramid() const
+{
+    if (segments.size() != 1) return nullptr;
+    const Segment &seg = segments[0];
+    if (seg.offset != 0 || seg.length != seg.pyramid->sampleCount()) return nullptr;
+    return seg.pyramid.data();
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QtGlobal>
+
+class SampleBuffer;
+
+// Résumé min/max et énergie multi-résolution (mipmap) d'un signal mono.
+// Niveau 0 : un pic par bloc de 256 échantillons, puis x16 à chaque niveau
+// (4096, 65536). Le pic d'une plage quelconque se calcule en lisant surtout
+// le niveau le plus grossier qui tient dans la plage : le coût ne dépend plus
+// de la longueur de la plage mais seulement de la largeur affichée.
+class PeakPyramid
+{
+public:
+    struct Peak {
+        float min = 0.0f;
+        float max = 0.0f;
+        // Somme des carrés : la valeur efficace (RMS) d'une plage de n
+        // échantillons vaut sqrt(energy / n)
+        double energy = 0.0;
+    };
+
+    static constexpr int LEVEL_COUNT = 3;
+    static constexpr int BASE_BLOCK  = 256;  // Échantillons par pic au niveau 0
+    static constexpr int LEVEL_RATIO = 16;   // Facteur entre deux niveaux
+
+    void clear();
+    void build(const SampleBuffer &samples);
+    // Ajout en fin de signal (chargement progressif) : seuls les derniers pics sont recalculés
+    void append(const float *samples, qint64 count);
+
+    qint64 sampleCount() const { return count; }
+    static qint64 blockSize(int level);
+
+    // Accès brut aux niveaux, pour la mise en cache sur disque (PeakCache)
+    const QVector<Peak> &level(int index) const { return levels[index]; }
+    // Reprend des niveaux déjà calculés ; false (et pyramide vide) s'ils sont incohérents
+    bool restore(qint64 sampleCount, const QVector<QVector<Peak>> &data);
+
+    // Pic et énergie de la plage [start, end). samples est le signal complet :
+    // il sert pour les bords de plage qui ne tombent pas sur un bloc ;
+    // origin y est la position du premier échantillon de la pyramide.
+    // Sans échantillons (nullptr), les bords sont approchés par les blocs du niveau 0
+    // (l'énergie d'un bloc partiellement couvert au prorata de la part couverte).
+    // *ok passe à faux si un bord n'a pas pu être lu (bloc illisible, voir SampleBuffer)
+    Peak peakRange(const SampleBuffer *samples, qint64 start, qint64 end, qint64 origin = 0,
+                   bool *ok = nullptr) const;
+
+private:
+    void accumulate(int level, const SampleBuffer *samples, qint64 origin, qint64 start, qint64 end,
+                    Peak &acc, bool &ok) const;
+
+    QVector<Peak> levels[LEVEL_COUNT];
+    qint64 count = 0;
+};
+
+// Pics d'un signal édité : liste de plages sur des pyramides immuables, comme
+// SampleBuffer sur ses blocs. Après une coupe ou une normalisation, seuls les
+// pics des échantillons nouveaux sont calculés ; ceux du reste du signal sont
+// repris tels quels, simplement décalés.
+class PeakTrack
+{
+public:
+    qint64 size() const { return total; }
+    void clear();
+    // Recalcule les pics de tout le signal
+    void build(const SampleBuffer &samples);
+    // Ajout en fin de signal (chargement progressif)
+    void append(const float *samples, qint64 count);
+    // [start, start + removed) a été remplacé par inserted échantillons,
+    // lus dans samples (le signal après modification)
+    void replace(const SampleBuffer &samples, qint64 start, qint64 removed, qint64 inserted);
+
+    // Pic et énergie de la plage [start, end) ; samples est le signal complet (ok : voir PeakPyramid)
+    PeakPyramid::Peak peakRange(const SampleBuffer *samples, qint64 start, qint64 end, bool *ok = nullptr) const;
+    // Pyramide de tout le signal s'il n'a pas été modifié (cache disque), sinon nullptr
+    const PeakPyramid *wholePyramid() const;
+
+private:
+    struct Segment {
+        QSharedPointer<PeakPyramid> pyramid;
+        qint64 offset = 0;      // Premier échantillon de la pyramide utilisé
+        qint64 length = 0;
+    };
+
+    int findSegment(qint64 pos) const;
+    int splitAt(qint64 pos);
+    void rebuildIndex(int from);
+
+    QVector<Segment> segments;
+    QVector<qint64> segmentStarts;     // Position de chaque plage dans le signal
+    qint64 total = 0;
+};
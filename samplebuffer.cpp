@@ -0,0 +1,430 @@
+#include "samplebuffer.h"
+#include "dspkernels.h"
+#include "samplestore.h"
+
+#include <cstring>
+#include <new>
+
+// ============================================================================
+// SAMPLEBLOCK
+// ============================================================================
+
+int SampleBlock::bytesPerSample(Encoding encoding)
+{
+    switch (encoding) {
+    case Encoding::Int16: return 2;
+    case Encoding::Int24: return 3;
+    case Encoding::Float32: break;
+    }
+    return 4;
+}
+
+SampleBlock::SampleBlock(qint64 capacity, Encoding encoding)
+    : cap(capacity)
+    , enc(encoding)
+{
+    if (!SampleStore::instance().allocate(this))
+        heap.reset(new uchar[capacityBytes()]);
+}
+
+SampleBlock::~SampleBlock()
+{
+    if (!heap) SampleStore::instance().release(this);
+}
+
+qint64 SampleBlock::append(const float *src, qint64 count, float gain)
+{
+    const qint64 n = std::min(count, cap - used);
+    if (n <= 0) return 0;
+
+    // Ni fichier d'échange ni RAM pour ce bloc : comme un new qui échoue
+    uchar *base = SampleStore::instance().pin(this);
+    if (!base) throw std::bad_alloc();
+    uchar *dst = base + used * bytesPerSample(enc);
+    // Même échelle que WavWriter : x * 2^(bits-1), arrondi et borné
+    switch (enc) {
+    case Encoding::Int16:
+        DspKernels::floatToInt16(src, reinterpret_cast<qint16 *>(dst), n, 32768.0f * gain);
+        break;
+    case Encoding::Int24:
+        DspKernels::floatToInt24(src, dst, n, 8388608.0f * gain);
+        break;
+    case Encoding::Float32:
+        if (gain == 1.0f)
+            std::memcpy(dst, src, n * sizeof(float));
+        else
+            DspKernels::scale(src, reinterpret_cast<float *>(dst), n, gain);
+        break;
+    }
+    SampleStore::instance().unpin(this);
+    used += n;
+    return n;
+}
+
+// Le bloc peut passer en RAM pendant pin() : c'est SampleStore, sous son
+// verrou, qui sait s'il est projeté ou non
+SampleBlock::Pin::Pin(const SampleBlock *block)
+    : block(block)
+    , ptr(SampleStore::instance().pin(block))
+{
+}
+
+SampleBlock::Pin::~Pin()
+{
+    if (ptr) SampleStore::instance().unpin(block);
+}
+
+void SampleBlock::Pin::decode(qint64 offset, float *dst, qint64 count) const
+{
+    switch (block->enc) {
+    case Encoding::Int16:
+        DspKernels::int16ToFloat(reinterpret_cast<const qint16 *>(ptr) + offset, dst, count);
+        break;
+    case Encoding::Int24:
+        DspKernels::int24ToFloat(ptr + offset * 3, dst, count);
+        break;
+    case Encoding::Float32:
+        std::memcpy(dst, floats() + offset, count * sizeof(float));
+        break;
+    }
+}
+
+// ============================================================================
+// SAMPLEBUFFER
+// ============================================================================
+
+void SampleBuffer::clear()
+{
+    pieces.clear();
+    pieceStarts.clear();
+    total = 0;
+}
+
+qint64 SampleBuffer::blockBytes(QSet<const SampleBlock *> &seen) const
+{
+    qint64 bytes = 0;
+    for (const Piece &p : pieces) {
+        const SampleBlock *block = p.block.data();
+        if (seen.contains(block)) continue;
+        seen.insert(block);
+        bytes += block->capacityBytes();
+    }
+    return bytes;
+}
+
+int SampleBuffer::findPiece(qint64 pos) const
+{
+    // Dernier morceau qui commence avant ou sur pos
+    auto it = std::upper_bound(pieceStarts.constBegin(), pieceStarts.constEnd(), pos);
+    return std::max(0, int(it - pieceStarts.constBegin()) - 1);
+}
+
+void SampleBuffer::rebuildIndex(int from)
+{
+    pieceStarts.resize(pieces.size());
+    for (int i = std::max(0, from); i < pieces.size(); ++i)
+        pieceStarts[i] = (i == 0) ? 0 : pieceStarts[i - 1] + pieces[i - 1].length;
+}
+
+int SampleBuffer::splitAt(qint64 pos)
+{
+    if (pos >= total) return pieces.size();
+    if (pos <= 0) return 0;
+
+    const int i = findPiece(pos);
+    const qint64 cut = pos - pieceStarts[i];
+    if (cut == 0) return i;
+
+    Piece right = pieces[i];
+    right.offset += cut;
+    right.length -= cut;
+    pieces[i].length = cut;
+    pieces.insert(i + 1, right);
+    pieceStarts.insert(i + 1, pos);
+    return i + 1;
+}
+
+float SampleBuffer::at(qint64 index) const
+{
+    if (index < 0 || index >= total) return 0.0f;
+    const int i = findPiece(index);
+    const Piece &p = pieces[i];
+    const SampleBlock::Pin pin(p.block.data());
+    if (!pin.isValid()) return 0.0f;
+    float v;
+    pin.decode(p.offset + index - pieceStarts[i], &v, 1);
+    return v;
+}
+
+qint64 SampleBuffer::read(qint64 start, float *dst, qint64 count) const
+{
+    qint64 copied = 0;
+    const bool ok = forEachSpan(start, start + count, [&](const float *src, qint64 n) {
+        std::memcpy(dst + copied, src, n * sizeof(float));
+        copied += n;
+    });
+    return ok ? copied : -1;
+}
+
+float SampleBuffer::absMax(qint64 start, qint64 end) const
+{
+    float mv = 0.0f;
+    forEachSpan(start, end, [&](const float *src, qint64 n) {
+        mv = std::max(mv, DspKernels::absMax(src, n));
+    });
+    return mv;
+}
+
+void SampleBuffer::append(const float *src, qint64 count)
+{
+    while (count > 0) {
+        // On complète le dernier bloc s'il est à nous : notre dernier morceau doit
+        // finir exactement là où le bloc s'arrête (sinon une autre version du
+        // signal y a déjà ajouté ses échantillons)
+        if (!pieces.isEmpty()) {
+            Piece &last = pieces.last();
+            if (last.offset + last.length == last.block->size()) {
+                const qint64 n = last.block->append(src, count);
+                if (n > 0) {
+                    last.length += n;
+                    total += n;
+                    src += n;
+                    count -= n;
+                    continue;
+                }
+            }
+        }
+
+        Piece piece;
+        piece.block = SampleBlockPtr(new SampleBlock(BLOCK_SIZE, enc));
+        pieces.append(piece);
+        pieceStarts.append(total);
+    }
+}
+
+void SampleBuffer::insert(qint64 pos, const SampleBuffer &source, qint64 start, qint64 count)
+{
+    pos = std::clamp<qint64>(pos, 0, total);
+    start = std::max<qint64>(0, start);
+    const qint64 end = std::min(start + count, source.total);
+    if (start >= end) return;
+
+    // Morceaux de source qui couvrent [start, end), rognés aux bornes ; relevés
+    // avant de découper ce signal, qui peut être source
+    QVector<Piece> inserted;
+    for (int i = source.findPiece(start); i < source.pieces.size() && source.pieceStarts[i] < end; ++i) {
+        const qint64 pieceStart = source.pieceStarts[i];
+        Piece p = source.pieces[i];
+        const qint64 from = std::max(start, pieceStart);
+        const qint64 to = std::min(end, pieceStart + p.length);
+        p.offset += from - pieceStart;
+        p.length = to - from;
+        inserted.append(p);
+    }
+
+    const int at = splitAt(pos);
+    pieces = pieces.mid(0, at) + inserted + pieces.mid(at);
+    total += end - start;
+    rebuildIndex(at);
+}
+
+void SampleBuffer::remove(qint64 start, qint64 count)
+{
+    start = std::max<qint64>(0, start);
+    const qint64 end = std::min(start + count, total);
+    if (start >= end) return;
+
+    const int first = splitAt(start);
+    const int last = splitAt(end);
+    pieces.remove(first, last - first);
+    total -= end - start;
+    rebuildIndex(first);
+}
+
+bool SampleBuffer::applyGain(qint64 start, qint64 end, float gain)
+{
+    start = std::max<qint64>(0, start);
+    end = std::min(end, total);
+    if (start >= end) return true;
+
+    const int first = splitAt(start);
+    const int last = splitAt(end);
+
+    // Chaque morceau de la plage est remplacé par des blocs neufs (au plus
+    // BLOCK_SIZE chacun, en float) : les anciens blocs restent intacts pour les
+    // autres versions du signal qui les référencent encore
+    QVector<Piece> result = pieces.mid(0, first);
+    for (int i = first; i < last; ++i) {
+        const qint64 pieceStart = pieceStarts[i];
+        const qint64 length = pieces[i].length;
+        for (qint64 done = 0; done < length; done += BLOCK_SIZE) {
+            Piece np;
+            np.length = std::min(BLOCK_SIZE, length - done);
+            bool ok = false;
+            try {
+                np.block = SampleBlockPtr(new SampleBlock(np.length));
+                ok = forEachSpan(pieceStart + done, pieceStart + done + np.length, [&np, gain](const float *src, qint64 n) {
+                    np.block->append(src, n, gain);
+                });
+            } catch (const std::bad_alloc &) {
+                // Nouveau bloc impossible à allouer ou à écrire (ni fichier d'échange ni RAM)
+            }
+            // Source illisible ou mémoire insuffisante : le signal reste tel quel
+            // (découpé aux bornes, sans effet)
+            if (!ok) return false;
+            result.append(np);
+        }
+    }
+    result.append(pieces.mid(last));
+
+    pieces = result;
+    rebuildIndex(first);
+    return true;
+}
+
+qint64 SampleBuffer::commonPrefix(const SampleBuffer &other) const
+{
+    // Parcours simultané des deux listes : les morceaux peuvent être découpés
+    // différemment, seuls comptent le bloc et la position dans le bloc
+    qint64 common = 0;
+    int i = 0, j = 0;
+    qint64 a = 0, b = 0;    // Échantillons déjà comparés dans les morceaux i et j
+    while (i < pieces.size() && j < other.pieces.size()) {
+        const Piece &p = pieces[i];
+        const Piece &q = other.pieces[j];
+        if (p.block != q.block || p.offset + a != q.offset + b) break;
+        const qint64 n = std::min(p.length - a, q.length - b);
+        common += n;
+        a += n;
+        b += n;
+        if (a == p.length) { ++i; a = 0; }
+        if (b == q.length) { ++j; b = 0; }
+    }
+    return common;
+}
+
+qint64 SampleBuffer::commonSuffix(const SampleBuffer &other) const
+{
+    // Même parcours, depuis la fin
+    qint64 common = 0;
+    int i = pieces.size() - 1, j = other.pieces.size() - 1;
+    qint64 a = 0, b = 0;
+    while (i >= 0 && j >= 0) {
+        const Piece &p = pieces[i];
+        const Piece &q = other.pieces[j];
+        if (p.block != q.block || p.offset + p.length - a != q.offset + q.length - b) break;
+        const qint64 n = std::min(p.length - a, q.length - b);
+        common += n;
+        a += n;
+        b += n;
+        if (a == p.length) { --i; a = 0; }
+        if (b == q.length) { --j; b = 0; }
+    }
+    return common;
+}
+
+// ============================================================================
+// MULTICHANNELBUFFER
+// ============================================================================
+
+void MultiChannelBuffer::setChannelCount(int count)
+{
+    channels = QVector<SampleBuffer>(std::max(1, count));
+    for (SampleBuffer &c : channels)
+        c.setEncoding(enc);
+}
+
+void MultiChannelBuffer::setEncoding(SampleBlock::Encoding encoding)
+{
+    enc = encoding;
+    for (SampleBuffer &c : channels)
+        c.setEncoding(encoding);
+}
+
+void MultiChannelBuffer::clear()
+{
+    for (SampleBuffer &c : channels)
+        c.clear();
+}
+
+qint64 MultiChannelBuffer::blockBytes(QSet<const SampleBlock *> &seen) const
+{
+    qint64 bytes = 0;
+    for (const SampleBuffer &c : channels)
+        bytes += c.blockBytes(seen);
+    return bytes;
+}
+
+qint64 MultiChannelBuffer::readInterleaved(qint64 start, float *dst, qint64 count) const
+{
+    const int n = channels.size();
+    qint64 frames = 0;
+    bool ok = true;
+    for (int c = 0; c < n; ++c) {
+        qint64 done = 0;
+        ok &= channels[c].forEachSpan(start, start + count, [&](const float *src, qint64 len) {
+            float *out = dst + done * n + c;
+            for (qint64 i = 0; i < len; ++i)
+                out[i * n] = src[i];
+            done += len;
+        });
+        frames = done;
+    }
+    return ok ? frames : -1;
+}
+
+float MultiChannelBuffer::absMax(qint64 start, qint64 end) const
+{
+    float mv = 0.0f;
+    for (const SampleBuffer &c : channels)
+        mv = std::max(mv, c.absMax(start, end));
+    return mv;
+}
+
+void MultiChannelBuffer::append(const QVector<QVector<float>> &planar)
+{
+    if (channels.size() != planar.size()) return;   // Signal d'un autre format : ignoré
+    for (int c = 0; c < channels.size(); ++c)
+        channels[c].append(planar[c]);
+}
+
+void MultiChannelBuffer::insert(qint64 pos, const MultiChannelBuffer &source, qint64 start, qint64 count)
+{
+    if (source.channelCount() != channelCount()) return;   // Signal d'un autre format : ignoré
+    for (int c = 0; c < channels.size(); ++c)
+        channels[c].insert(pos, source.channels[c], start, count);
+}
+
+void MultiChannelBuffer::remove(qint64 start, qint64 count)
+{
+    for (SampleBuffer &c : channels)
+        c.remove(start, count);
+}
+
+bool MultiChannelBuffer::applyGain(qint64 start, qint64 end, float gain)
+{
+    // Sur une copie (listes de morceaux) : tous les canaux changent, ou aucun
+    QVector<SampleBuffer> result = channels;
+    for (SampleBuffer &c : result)
+        if (!c.applyGain(start, end, gain)) return false;
+    channels = result;
+    return true;
+}
+
+qint64 MultiChannelBuffer::commonPrefix(const MultiChannelBuffer &other) const
+{
+    if (channels.size() != other.channels.size()) return 0;
+    qint64 common = std::min(size(), other.size());
+    for (int c = 0; c < channels.size() && common > 0; ++c)
+        common = std::min(common, channels[c].commonPrefix(other.channels[c]));
+    return common;
+}
+
+qint64 MultiChannelBuffer::commonSuffix(const MultiChannelBuffer &other) const
+{
+    if (channels.size() != other.channels.size()) return 0;
+    qint64 common = std::min(size(), other.size());
+    for (int c = 0; c < channels.size() && common > 0; ++c)
+        common = std::min(common, channels[c].commonSuffix(other.channels[c]));
+    return common;
+}
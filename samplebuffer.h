@@ -0,0 +1,223 @@
+#pragma once
+
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm>
+#include <memory>
+
+// Bloc d'échantillons partagé entre plusieurs versions du signal.
+// Les échantillons déjà écrits ne changent jamais : on peut seulement en
+// ajouter à la suite, dans la capacité réservée à la création (chargement).
+// Le bloc vit dans le fichier d'échange (SampleStore) et n'est en mémoire que
+// pendant qu'on y accède, par un Pin ; à défaut de fichier, il reste en RAM.
+// Un bloc peut garder la résolution d'une source entière (16 ou 24 bits) :
+// il occupe alors 2 ou 3 octets par échantillon au lieu de 4, et n'est
+// converti en float que par petites portions, au moment de la lecture.
+class SampleBlock
+{
+public:
+    enum class Encoding { Float32, Int16, Int24 };
+    static int bytesPerSample(Encoding encoding);
+    // Dimension des portions converties en float (SampleBuffer::forEachSpan)
+    static constexpr qint64 DECODE_CHUNK = 4096;
+
+    explicit SampleBlock(qint64 capacity, Encoding encoding = Encoding::Float32);
+    ~SampleBlock();
+
+    qint64 size() const { return used; }
+    qint64 capacity() const { return cap; }
+    Encoding encoding() const { return enc; }
+    qint64 capacityBytes() const { return cap * bytesPerSample(enc); }
+
+    // Copie au plus capacity() - size() échantillons (multipliés par gain) ;
+    // renvoie le nombre copié. En 16/24 bits, les valeurs sont quantifiées :
+    // sans perte pour un signal venant d'une source de même résolution.
+    qint64 append(const float *src, qint64 count, float gain = 1.0f);
+
+    // Accès aux échantillons bruts (dans l'encodage du bloc) : le pointeur
+    // reste valide tant que le Pin existe
+    class Pin
+    {
+    public:
+        explicit Pin(const SampleBlock *block);
+        ~Pin();
+        // Faux si le bloc n'a pas pu être chargé (fichier d'échange inaccessible
+        // et RAM insuffisante) : ses échantillons sont alors illisibles
+        bool isValid() const { return ptr != nullptr; }
+        const uchar *data() const { return ptr; }
+        // Float32 uniquement
+        const float *floats() const { return reinterpret_cast<const float *>(ptr); }
+        // Convertit [offset, offset + count) en float dans dst
+        void decode(qint64 offset, float *dst, qint64 count) const;
+
+    private:
+        Q_DISABLE_COPY(Pin)
+        const SampleBlock *block;
+        const uchar *ptr;
+    };
+
+private:
+    Q_DISABLE_COPY(SampleBlock)
+    friend class SampleStore;
+
+    // Bloc en RAM (pas de fichier d'échange, ou projection impossible) ;
+    // modifié seulement par SampleStore, sous son verrou
+    std::unique_ptr<uchar[]> heap;
+    qint64 slotOffset = -1;             // Place dans le fichier d'échange
+    qint64 slotBytes = 0;
+    mutable uchar *mappedData = nullptr;
+    mutable int pins = 0;
+    mutable quint64 lastUse = 0;
+    qint64 used = 0;
+    qint64 cap = 0;
+    Encoding enc = Encoding::Float32;
+};
+
+using SampleBlockPtr = QSharedPointer<SampleBlock>;
+
+// Signal mono stocké sous forme de table de morceaux (piece table) : le signal
+// édité n'est qu'une liste de plages (bloc, début, longueur) sur des blocs
+// immuables. Couper ne déplace aucun échantillon (coût en nombre de morceaux),
+// et copier un SampleBuffer ne copie que la liste des morceaux.
+class SampleBuffer
+{
+public:
+    static constexpr qint64 BLOCK_SIZE = 1 << 20;   // Échantillons par bloc créé
+
+    qint64 size() const { return total; }
+    bool isEmpty() const { return total == 0; }
+    int pieceCount() const { return pieces.size(); }
+    void clear();
+
+    // Encodage des blocs créés par append() ; les blocs recalculés (gain)
+    // sont toujours en float, pour ne pas requantifier le signal à chaque édition
+    SampleBlock::Encoding encoding() const { return enc; }
+    void setEncoding(SampleBlock::Encoding encoding) { enc = encoding; }
+
+    // Mémoire des blocs référencés qui ne sont pas déjà dans seen (ajoutés au passage) :
+    // permet de compter ce que plusieurs versions du signal occupent réellement
+    qint64 blockBytes(QSet<const SampleBlock *> &seen) const;
+
+    float at(qint64 index) const;
+    // Copie [start, start + count) dans dst ; renvoie le nombre d'échantillons
+    // copiés, ou -1 si un bloc était illisible (remplacé par des zéros)
+    qint64 read(qint64 start, float *dst, qint64 count) const;
+    float absMax(qint64 start, qint64 end) const;
+
+    void append(const float *src, qint64 count);
+    void append(const QVector<float> &src) { append(src.constData(), src.size()); }
+    // Insère à pos les échantillons [start, start + count) de source sans les
+    // copier : les morceaux insérés partagent les blocs de source (source peut
+    // être ce signal lui-même)
+    void insert(qint64 pos, const SampleBuffer &source, qint64 start, qint64 count);
+    void remove(qint64 start, qint64 count);
+    // Multiplie [start, end) par gain : seuls les échantillons de la plage sont recopiés.
+    // Faux (signal inchangé) si un bloc de la plage était illisible ou si la
+    // mémoire manquait pour les nouveaux blocs : ne lève pas std::bad_alloc.
+    bool applyGain(qint64 start, qint64 end, float gain);
+
+    // Longueur du début (ou de la fin) commun avec other : mêmes plages des
+    // mêmes blocs. Sert à retrouver la plage modifiée entre deux versions.
+    qint64 commonPrefix(const SampleBuffer &other) const;
+    qint64 commonSuffix(const SampleBuffer &other) const;
+
+    // Appelle f(const float *data, qint64 count) sur chaque portion contiguë de [start, end).
+    // Les blocs float sont passés directement ; les blocs 16/24 bits sont
+    // convertis par portions d'au plus DECODE_CHUNK échantillons.
+    // Un bloc illisible (voir Pin::isValid) est passé comme du silence et la
+    // fonction renvoie faux : à l'appelant de décider (silence à la lecture,
+    // erreur à la sauvegarde).
+    template<typename F>
+    bool forEachSpan(qint64 start, qint64 end, F f) const
+    {
+        start = std::max<qint64>(0, start);
+        end = std::min(end, total);
+        if (start >= end) return true;
+
+        bool ok = true;
+        float chunk[SampleBlock::DECODE_CHUNK];
+        for (int i = findPiece(start); i < pieces.size() && start < end; ++i) {
+            const Piece &p = pieces[i];
+            const qint64 skip = start - pieceStarts[i];
+            const qint64 n = std::min(p.length - skip, end - start);
+            const SampleBlock::Pin pin(p.block.data());
+            if (!pin.isValid()) {
+                ok = false;
+                std::fill(chunk, chunk + std::min(n, SampleBlock::DECODE_CHUNK), 0.0f);
+                for (qint64 done = 0; done < n; done += SampleBlock::DECODE_CHUNK)
+                    f(static_cast<const float *>(chunk), std::min(SampleBlock::DECODE_CHUNK, n - done));
+            } else if (p.block->encoding() == SampleBlock::Encoding::Float32) {
+                f(pin.floats() + p.offset + skip, n);
+            } else {
+                for (qint64 done = 0; done < n; done += SampleBlock::DECODE_CHUNK) {
+                    const qint64 m = std::min(SampleBlock::DECODE_CHUNK, n - done);
+                    pin.decode(p.offset + skip + done, chunk, m);
+                    f(static_cast<const float *>(chunk), m);
+                }
+            }
+            start += n;
+        }
+        return ok;
+    }
+
+private:
+    struct Piece {
+        SampleBlockPtr block;
+        qint64 offset = 0;
+        qint64 length = 0;
+    };
+
+    int findPiece(qint64 pos) const;   // Morceau qui contient pos
+    int splitAt(qint64 pos);           // Coupe à pos ; renvoie l'index du morceau qui y commence
+    void rebuildIndex(int from);
+
+    QVector<Piece> pieces;
+    QVector<qint64> pieceStarts;       // Position de chaque morceau dans le signal
+    qint64 total = 0;
+    SampleBlock::Encoding enc = SampleBlock::Encoding::Float32;
+};
+
+// Signal multicanal planaire : un SampleBuffer par canal, tous de même
+// longueur. Les éditions s'appliquent à tous les canaux à la fois ; chaque
+// canal garde son propre partage de blocs (copie = listes de morceaux).
+class MultiChannelBuffer
+{
+public:
+    int channelCount() const { return channels.size(); }
+    // Change le nombre de canaux ; le signal est vidé
+    void setChannelCount(int count);
+    // Encodage des prochains échantillons ajoutés (voir SampleBuffer)
+    void setEncoding(SampleBlock::Encoding encoding);
+    qint64 size() const { return channels.isEmpty() ? 0 : channels[0].size(); }
+    bool isEmpty() const { return size() == 0; }
+    void clear();
+
+    const SampleBuffer &channel(int index) const { return channels[index]; }
+    qint64 blockBytes(QSet<const SampleBlock *> &seen) const;
+
+    // Copie les trames [start, start + count) entrelacées dans dst
+    // (count * channelCount() valeurs) ; renvoie le nombre de trames copiées,
+    // ou -1 si un bloc était illisible (silence à sa place)
+    qint64 readInterleaved(qint64 start, float *dst, qint64 count) const;
+    // Maximum absolu sur tous les canaux
+    float absMax(qint64 start, qint64 end) const;
+
+    // Un vecteur par canal, de même longueur
+    void append(const QVector<QVector<float>> &planar);
+    // Voir SampleBuffer ; source doit avoir le même nombre de canaux
+    void insert(qint64 pos, const MultiChannelBuffer &source, qint64 start, qint64 count);
+    void remove(qint64 start, qint64 count);
+    // Faux (signal inchangé) si un bloc de la plage était illisible ou si la
+    // mémoire manquait (voir SampleBuffer)
+    bool applyGain(qint64 start, qint64 end, float gain);
+
+    // Début / fin communs à tous les canaux (voir SampleBuffer)
+    qint64 commonPrefix(const MultiChannelBuffer &other) const;
+    qint64 commonSuffix(const MultiChannelBuffer &other) const;
+
+private:
+    QVector<SampleBuffer> channels;
+    SampleBlock::Encoding enc = SampleBlock::Encoding::Float32;
+};
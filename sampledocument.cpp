@@ -0,0 +1,65 @@
+#include "sampledocument.h"
+
+SampleDocument::SampleDocument(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void SampleDocument::setChannelCount(int count)
+{
+    buffer.setChannelCount(count);
+    emit reset();
+}
+
+void SampleDocument::clear()
+{
+    if (buffer.isEmpty()) return;
+    buffer.clear();
+    emit reset();
+}
+
+void SampleDocument::append(const QVector<QVector<float>> &planar)
+{
+    const qint64 oldSize = buffer.size();
+    buffer.append(planar);
+    if (buffer.size() > oldSize)
+        emit changed(oldSize, 0, buffer.size() - oldSize);
+}
+
+void SampleDocument::remove(qint64 start, qint64 count)
+{
+    const qint64 oldSize = buffer.size();
+    buffer.remove(start, count);
+    if (buffer.size() < oldSize)
+        emit changed(start, oldSize - buffer.size(), 0);
+}
+
+bool SampleDocument::applyGain(qint64 start, qint64 end, float gain)
+{
+    start = std::max<qint64>(0, start);
+    end = std::min(end, buffer.size());
+    if (start >= end) return true;
+    if (!buffer.applyGain(start, end, gain)) return false;
+    emit changed(start, end - start, end - start);
+    return true;
+}
+
+void SampleDocument::replace(const MultiChannelBuffer &samples)
+{
+    if (samples.channelCount() != buffer.channelCount()) {
+        buffer = samples;
+        emit reset();
+        return;
+    }
+
+    const qint64 oldSize = buffer.size();
+    const qint64 prefix = buffer.commonPrefix(samples);
+    const qint64 suffix = std::min(buffer.commonSuffix(samples),
+                                   std::min(oldSize, samples.size()) - prefix);
+    buffer = samples;
+
+    const qint64 removed = oldSize - prefix - suffix;
+    const qint64 inserted = samples.size() - prefix - suffix;
+    if (removed > 0 || inserted > 0)
+        emit changed(prefix, removed, inserted);
+}
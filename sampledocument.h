@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+#include "samplebuffer.h"
+
+// Signal édité, partagé entre l'éditeur (qui le modifie) et la forme d'onde
+// (qui l'affiche) : une seule instance, et chaque modification annonce la
+// plage touchée. La forme d'onde ne recalcule ainsi que les pics de cette
+// plage au lieu de tout le fichier.
+// À n'utiliser que depuis le thread graphique ; la lecture et la sauvegarde
+// travaillent sur des copies (listes de morceaux) de samples().
+class SampleDocument : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SampleDocument(QObject *parent = nullptr);
+
+    const MultiChannelBuffer &samples() const { return buffer; }
+    qint64 size() const { return buffer.size(); }
+    int channelCount() const { return buffer.channelCount(); }
+    bool isEmpty() const { return buffer.isEmpty(); }
+
+    // Encodage des prochains échantillons ajoutés (voir SampleBuffer)
+    void setEncoding(SampleBlock::Encoding encoding) { buffer.setEncoding(encoding); }
+    // Change le nombre de canaux ; le signal est vidé
+    void setChannelCount(int count);
+    void clear();
+
+    // Un vecteur par canal, ajouté en fin de signal
+    void append(const QVector<QVector<float>> &planar);
+    void remove(qint64 start, qint64 count);
+    // Faux si le signal n'a pas pu être lu ou si la mémoire manquait (il reste alors inchangé)
+    bool applyGain(qint64 start, qint64 end, float gain);
+    // Remplace tout le signal (annuler / rétablir) : seule la plage qui diffère
+    // (hors préfixe et suffixe communs) est annoncée comme modifiée
+    void replace(const MultiChannelBuffer &samples);
+
+signals:
+    // Tout le signal a changé (nouveau fichier, autres canaux)
+    void reset();
+    // [start, start + removed) a été remplacé par inserted échantillons ;
+    // ce qui suivait est décalé de inserted - removed
+    void changed(qint64 start, qint64 removed, qint64 inserted);
+
+private:
+    MultiChannelBuffer buffer;
+};
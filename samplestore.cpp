@@ -0,0 +1,194 @@
+#include "samplestore.h"
+#include "samplebuffer.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <new>
+#include <utility>
+
+// Taille de place pour bytes octets : puissance de deux, au moins une page ;
+// classe = log2(place / MIN_SLOT_BYTES)
+static int slotClass(qint64 bytes)
+{
+    int k = 0;
+    while ((SampleStore::MIN_SLOT_BYTES << k) < bytes) ++k;
+    return k;
+}
+
+SampleStore &SampleStore::instance()
+{
+    static SampleStore store;
+    return store;
+}
+
+SampleStore::SampleStore() = default;
+
+SampleStore::~SampleStore()
+{
+    // Les blocs encore vivants à la sortie du programme n'ont plus de lecteur
+    for (const SampleBlock *block : std::as_const(mapped))
+        file->unmap(block->mappedData);
+    delete file;    // QTemporaryFile : le fichier d'échange est supprimé
+}
+
+void SampleStore::setResidentBudget(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+    // Au moins quelques blocs, sinon chaque lecture remappe sans cesse
+    budget = std::max(bytes, 16 * MAX_SLOT_BYTES);
+    evict(budget);
+}
+
+void SampleStore::setDirectory(const QString &dir)
+{
+    QMutexLocker locker(&mutex);
+    directory = dir;
+}
+
+qint64 SampleStore::residentBytes() const
+{
+    QMutexLocker locker(&mutex);
+    return mappedBytes;
+}
+
+bool SampleStore::openFile()
+{
+    if (file) return true;
+    if (fileFailed) return false;
+
+    const QString dir = directory.isEmpty()
+        ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/scratch"
+        : directory;
+    QDir().mkpath(dir);
+
+    file = new QTemporaryFile(dir + "/samples-XXXXXX.scratch");
+    if (!file->open()) {
+        qWarning("SampleStore: fichier d'échange indisponible (%s), échantillons gardés en RAM",
+                 qPrintable(file->errorString()));
+        delete file;
+        file = nullptr;
+        fileFailed = true;      // On ne réessaie pas à chaque bloc
+        return false;
+    }
+    return true;
+}
+
+bool SampleStore::allocate(SampleBlock *block)
+{
+    const qint64 bytes = block->capacityBytes();
+    if (bytes > MAX_SLOT_BYTES) return false;
+
+    QMutexLocker locker(&mutex);
+    if (!openFile()) return false;
+
+    const int k = slotClass(bytes);
+    if (freeSlots.size() <= k) freeSlots.resize(k + 1);
+    block->slotBytes = MIN_SLOT_BYTES << k;
+    if (!freeSlots[k].isEmpty()) {
+        block->slotOffset = freeSlots[k].takeLast();
+        return true;
+    }
+    // Le fichier grandit d'une place ; il reste creux tant qu'on n'écrit pas.
+    // Les places, puissances de deux ajoutées bout à bout, restent alignées sur une page.
+    if (!file->resize(fileSize + block->slotBytes)) return false;
+    block->slotOffset = fileSize;
+    fileSize += block->slotBytes;
+    return true;
+}
+
+void SampleStore::release(SampleBlock *block)
+{
+    QMutexLocker locker(&mutex);
+    if (block->slotOffset < 0) return;
+    if (block->mappedData) unmap(block);
+    freeSlot(block);
+}
+
+void SampleStore::freeSlot(const SampleBlock *block)
+{
+    SampleBlock *b = const_cast<SampleBlock *>(block);
+    freeSlots[slotClass(b->slotBytes)].append(b->slotOffset);
+    b->slotOffset = -1;
+    b->slotBytes = 0;
+}
+
+uchar *SampleStore::pin(const SampleBlock *block)
+{
+    QMutexLocker locker(&mutex);
+    if (block->heap) return block->heap.get();     // Bloc en RAM : rien à projeter ni compter
+
+    if (!block->mappedData) {
+        const qint64 bytes = block->slotBytes;
+        evict(budget - bytes);
+
+        uchar *p = file->map(block->slotOffset, bytes);
+        if (!p) {
+            // Espace d'adressage épuisé : on libère tout ce qui peut l'être
+            evict(0);
+            p = file->map(block->slotOffset, bytes);
+        }
+        if (!p) {
+            // Toujours impossible (disque plein, dossier inaccessible) : le bloc
+            // passe en RAM plutôt que d'interrompre la lecture ou la sauvegarde
+            return moveToHeap(block) ? block->heap.get() : nullptr;
+        }
+
+        block->mappedData = p;
+        mapped.insert(block);
+        mappedBytes += bytes;
+    }
+    ++block->pins;
+    block->lastUse = ++clock;
+    return block->mappedData;
+}
+
+void SampleStore::unpin(const SampleBlock *block)
+{
+    QMutexLocker locker(&mutex);
+    // Un bloc épinglé est projeté, il ne peut pas être passé en RAM entre-temps
+    if (!block->heap) --block->pins;
+}
+
+bool SampleStore::moveToHeap(const SampleBlock *block)
+{
+    SampleBlock *b = const_cast<SampleBlock *>(block);
+    std::unique_ptr<uchar[]> heap(new (std::nothrow) uchar[b->capacityBytes()]);
+    if (!heap) return false;
+
+    // Seuls les échantillons déjà écrits sont relus (lecture simple, sans projection)
+    const qint64 bytes = b->used * SampleBlock::bytesPerSample(b->enc);
+    if (bytes > 0 && (!file->seek(b->slotOffset) || file->read(reinterpret_cast<char *>(heap.get()), bytes) != bytes)) {
+        qWarning("SampleStore: bloc illisible dans le fichier d'échange (%s)", qPrintable(file->errorString()));
+        return false;
+    }
+    if (!heapFallbackWarned) {
+        qWarning("SampleStore: projection impossible (%s), blocs gardés en RAM", qPrintable(file->errorString()));
+        heapFallbackWarned = true;
+    }
+    b->heap = std::move(heap);
+    freeSlot(b);
+    return true;
+}
+
+void SampleStore::unmap(const SampleBlock *block)
+{
+    file->unmap(block->mappedData);
+    block->mappedData = nullptr;
+    mapped.remove(block);
+    mappedBytes -= block->slotBytes;
+}
+
+void SampleStore::evict(qint64 target)
+{
+    // Peu de blocs projetés (budget / taille des blocs) : une recherche linéaire suffit
+    while (mappedBytes > target) {
+        const SampleBlock *oldest = nullptr;
+        for (const SampleBlock *block : std::as_const(mapped)) {
+            if (block->pins == 0 && (!oldest || block->lastUse < oldest->lastUse))
+                oldest = block;
+        }
+        if (!oldest) return;    // Tout est en cours d'utilisation
+        unmap(oldest);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+class QTemporaryFile;
+class SampleBlock;
+
+// Fichier d'échange des blocs d'échantillons : chaque bloc occupe une place
+// dans un fichier temporaire et n'est projeté en mémoire (QFile::map) que
+// lorsqu'on le lit ou l'écrit. Au-delà du budget, les blocs projetés les
+// moins récemment utilisés sont libérés ; le système relit les pages à la
+// demande. On peut ainsi éditer des fichiers bien plus gros que la RAM.
+// Les places sont taillées sur la capacité du bloc (puissance de deux, d'une
+// page à MAX_SLOT_BYTES) : les petits blocs des éditions restent petits.
+// Si la projection échoue (disque plein, espace d'adressage épuisé), le bloc
+// est rapatrié en RAM ; pin() ne renvoie nullptr que si la RAM manque aussi.
+// Sûr entre threads (lecture, sauvegarde et affichage lisent en parallèle).
+class SampleStore
+{
+public:
+    // Plus grande place (octets) : les blocs plus grands restent en RAM
+    static constexpr qint64 MAX_SLOT_BYTES = qint64(4) << 20;
+    // Plus petite place : une page
+    static constexpr qint64 MIN_SLOT_BYTES = 4096;
+
+    static SampleStore &instance();
+
+    // Budget de mémoire projetée (octets) et dossier du fichier d'échange ;
+    // le dossier n'est pris en compte qu'à la création du fichier
+    void setResidentBudget(qint64 bytes);
+    void setDirectory(const QString &dir);
+    qint64 residentBytes() const;
+
+    // Réserve une place pour block ; false si le fichier d'échange est
+    // indisponible (le bloc reste alors en RAM)
+    bool allocate(SampleBlock *block);
+    void release(SampleBlock *block);
+
+    // Projette le bloc et le garde en mémoire jusqu'à unpin() ; nullptr si le
+    // bloc n'a pu être ni projeté ni rapatrié en RAM (à traiter comme illisible)
+    uchar *pin(const SampleBlock *block);
+    void unpin(const SampleBlock *block);
+
+private:
+    SampleStore();
+    ~SampleStore();
+    Q_DISABLE_COPY(SampleStore)
+
+    bool openFile();
+    void unmap(const SampleBlock *block);
+    // Projection impossible : copie le bloc en RAM et rend sa place
+    bool moveToHeap(const SampleBlock *block);
+    void freeSlot(const SampleBlock *block);
+    // Libère les blocs non épinglés les plus anciens jusqu'à respecter le budget
+    void evict(qint64 target);
+
+    mutable QMutex mutex;
+    QTemporaryFile *file = nullptr;
+    QString directory;
+    bool fileFailed = false;
+    bool heapFallbackWarned = false;
+
+    // Places libres par taille : freeSlots[k] = positions des places de MIN_SLOT_BYTES << k
+    QVector<QVector<qint64>> freeSlots;
+    qint64 fileSize = 0;
+
+    QSet<const SampleBlock *> mapped;
+    qint64 mappedBytes = 0;
+    qint64 budget = qint64(1024) * 1024 * 1024;
+    quint64 clock = 0;
+};
@@ -0,0 +1,251 @@
+#include "savejob.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QThread>
+
+#include <algorithm>
+#include <memory>
+
+#if defined(Q_OS_WIN)
+#include <qt_windows.h>
+#include <io.h>
+#include <string>
+#else
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Alimentation de FFmpeg : blocs de 256 Ki échantillons (1 Mo), au plus 4 Mo en attente
+static const qint64 FEED_SAMPLES = 1 << 18;
+static const qint64 FEED_BYTES_IN_FLIGHT = 4 << 20;
+
+SaveJob::SaveJob(const Request &request, QObject *parent)
+    : QObject(parent)
+    , request(request)
+{
+}
+
+void SaveJob::cancel()
+{
+    cancelRequested = true;
+}
+
+// Le résultat est d'abord écrit à côté de la cible (même système de fichiers),
+// puis la remplace par renommage : une annulation ou une erreur laisse le
+// fichier d'origine intact, et il n'y a jamais de copie complète
+QString SaveJob::siblingTempPath() const
+{
+    const QFileInfo fi(request.targetFile);
+    return fi.dir().filePath(QString(".%1.saving.%2").arg(fi.completeBaseName(), fi.suffix()));
+}
+
+void SaveJob::run()
+{
+    QString errorMessage;
+    const QString partial = siblingTempPath();
+    QFile::remove(partial);
+
+    bool ok = false;
+    if (request.targetFile.endsWith(".wav", Qt::CaseInsensitive)) {
+        ok = writeWav(partial, errorMessage);
+    } else {
+        ok = encodeWithFFmpeg(partial, errorMessage);
+    }
+
+    if (!ok || cancelRequested) {
+        QFile::remove(partial);
+        emit finished(false, cancelRequested ? QString() : errorMessage);
+        return;
+    }
+
+    // Passé ce point, l'annulation n'a plus d'effet
+    emit progress(1.0, tr("Remplacement du fichier..."));
+    if (!replaceFile(partial, request.targetFile, errorMessage)) {
+        QFile::remove(partial);
+        emit finished(false, errorMessage);
+        return;
+    }
+    emit finished(true, QString());
+}
+
+bool SaveJob::writeWav(const QString &path, QString &errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = tr("Impossible d'écrire le fichier %1 :\n%2").arg(path, file.errorString());
+        return false;
+    }
+
+    const QString stage = tr("Écriture du WAV...");
+    emit progress(0.0, stage);
+    auto onProgress = [&](qint64 written, qint64 total) {
+        emit progress(total > 0 ? double(written) / total : 1.0, stage);
+        return !cancelRequested.load();
+    };
+
+    const bool ok = WavWriter::write(&file, request.samples, request.format, &errorMessage, onProgress)
+                    && file.flush();
+    if (ok) return true;
+    if (errorMessage.isEmpty()) errorMessage = file.errorString();
+    file.close();
+    file.remove();
+    return false;
+}
+
+// Lit les lignes "clé=valeur" de -progress et publie l'avancement
+void SaveJob::readFFmpegProgress(QProcess &ff, QByteArray &pending, double durationUs)
+{
+    pending += ff.readAllStandardOutput();
+    int eol;
+    while ((eol = pending.indexOf('\n')) >= 0) {
+        const QByteArray line = pending.left(eol).trimmed();
+        pending.remove(0, eol + 1);
+        if (line.startsWith("out_time_us=") && durationUs > 0) {
+            bool ok = false;
+            const qint64 us = line.mid(12).toLongLong(&ok);
+            if (ok && us >= 0) emit progress(std::min(1.0, us / durationUs), tr("Encodage..."));
+        }
+    }
+}
+
+bool SaveJob::encodeWithFFmpeg(const QString &output, QString &errorMessage)
+{
+    // Le signal est envoyé tel quel sur l'entrée standard (float 32 bits entrelacé,
+    // little-endian en mémoire sur toutes nos cibles) : pas de WAV intermédiaire
+    const int channels = std::max(1, request.samples.channelCount());
+    QStringList args;
+    args << "-hide_banner" << "-nostats" << "-progress" << "pipe:1"
+         << "-f" << "f32le" << "-ar" << QString::number(request.format.sampleRate)
+         << "-ac" << QString::number(channels)
+         << "-i" << "pipe:0" << "-y";
+
+    if (request.targetFile.endsWith(".mp3", Qt::CaseInsensitive)) {
+        args << "-codec:a" << "libmp3lame" << "-q:a" << "2";
+    } else if (request.targetFile.endsWith(".m4a", Qt::CaseInsensitive)) {
+        args << "-codec:a" << "aac" << "-b:a" << "192k";
+    }
+    args << output;
+
+    const qint64 total = request.samples.size();
+    const double durationUs = request.format.sampleRate > 0
+        ? double(total) * 1e6 / request.format.sampleRate : 0.0;
+    emit progress(0.0, tr("Encodage..."));
+
+    QProcess ff;
+    ff.start(request.ffmpegPath, args);
+    if (!ff.waitForStarted()) {
+        errorMessage = tr("Impossible de lancer FFmpeg : %1").arg(ff.errorString());
+        return false;
+    }
+
+    auto abort = [&]() {
+        ff.kill();
+        ff.waitForFinished();
+        return false;
+    };
+
+    // Pas de délai maximal : un long fichier peut prendre plusieurs minutes.
+    // Contre-pression : au-delà de FEED_BYTES_IN_FLIGHT non consommés par FFmpeg,
+    // on attend avant de lire le bloc suivant ; la mémoire reste bornée.
+    QByteArray pending;
+    const qint64 feedFrames = std::max<qint64>(1, FEED_SAMPLES / channels);
+    std::unique_ptr<float[]> block(new float[feedFrames * channels]);
+    for (qint64 start = 0; start < total; ) {
+        if (cancelRequested) return abort();
+        if (ff.state() == QProcess::NotRunning) break;     // FFmpeg a échoué : on lira stderr
+
+        if (ff.bytesToWrite() > FEED_BYTES_IN_FLIGHT) {
+            ff.waitForBytesWritten(100);
+        } else {
+            const qint64 n = request.samples.readInterleaved(start, block.get(), std::min(feedFrames, total - start));
+            if (n < 0) {
+                errorMessage = tr("Impossible de lire les échantillons (fichier d'échange inaccessible et mémoire insuffisante).");
+                return abort();
+            }
+            ff.write(reinterpret_cast<const char *>(block.get()), n * channels * qint64(sizeof(float)));
+            start += n;
+        }
+        readFFmpegProgress(ff, pending, durationUs);
+    }
+
+    // Vide le tampon d'écriture puis signale la fin du flux
+    while (ff.bytesToWrite() > 0 && ff.state() != QProcess::NotRunning) {
+        if (cancelRequested) return abort();
+        ff.waitForBytesWritten(100);
+        readFFmpegProgress(ff, pending, durationUs);
+    }
+    ff.closeWriteChannel();
+
+    while (ff.state() != QProcess::NotRunning) {
+        if (cancelRequested) return abort();
+        ff.waitForFinished(100);
+        readFFmpegProgress(ff, pending, durationUs);
+    }
+
+    if (ff.exitStatus() != QProcess::NormalExit || ff.exitCode() != 0) {
+        errorMessage = tr("Échec encodage: %1").arg(QString::fromLocal8Bit(ff.readAllStandardError().right(2000)));
+        return false;
+    }
+    return true;
+}
+
+// Force l'écriture du fichier sur le disque avant de le renommer : sans cela,
+// une coupure juste après le renommage peut laisser un fichier vide
+static bool syncToDisk(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+#if defined(Q_OS_WIN)
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+bool SaveJob::replaceFile(const QString &source, const QString &target, QString &errorMessage)
+{
+    if (!syncToDisk(source)) {
+        errorMessage = tr("Impossible d'écrire le fichier %1 sur le disque.").arg(source);
+        return false;
+    }
+    // Comme QSaveFile : le nouveau fichier garde les droits de l'ancien
+    if (QFile::exists(target))
+        QFile::setPermissions(source, QFile::permissions(target));
+
+    // Renommage atomique dans le même dossier : à tout instant, la cible est
+    // soit l'ancien fichier complet, soit le nouveau ; jamais absente.
+#if defined(Q_OS_WIN)
+    // Le fichier cible peut être brièvement verrouillé (antivirus, indexation) :
+    // on insiste 10 fois avec 100 ms de pause
+    const std::wstring from = QDir::toNativeSeparators(source).toStdWString();
+    const std::wstring to = QDir::toNativeSeparators(target).toStdWString();
+    bool moved = false;
+    for (int i = 0; i < 10 && !moved; ++i) {
+        moved = MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+        if (!moved) QThread::msleep(100);
+    }
+    if (!moved) {
+        errorMessage = tr("Impossible d'écraser le fichier.\nIl est peut-être utilisé par une autre application ou l'antivirus.");
+        return false;
+    }
+#else
+    if (::rename(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) != 0) {
+        errorMessage = tr("Impossible de remplacer le fichier %1 :\n%2")
+                           .arg(target, QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+    // Le renommage lui-même doit atteindre le disque : on synchronise le dossier
+    const int dirFd = ::open(QFile::encodeName(QFileInfo(target).absolutePath()).constData(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include "samplebuffer.h"
+#include "wavwriter.h"
+
+class QProcess;
+
+// Sauvegarde du signal édité hors du thread graphique : écriture WAV, ou
+// encodage FFmpeg alimenté par son entrée standard pour les autres formats.
+// Le travail porte sur une copie du signal (listes de morceaux sur des
+// blocs immuables) : l'éditeur peut continuer à modifier le signal pendant
+// la sauvegarde.
+// L'objet vit dans un QThread dédié : on l'appelle via QMetaObject::invokeMethod.
+class SaveJob : public QObject
+{
+    Q_OBJECT
+public:
+    struct Request {
+        MultiChannelBuffer samples;
+        WavWriter::Format format;
+        QString targetFile;
+        QString ffmpegPath;
+    };
+
+    explicit SaveJob(const Request &request, QObject *parent = nullptr);
+
+    // Appelable depuis n'importe quel thread : interrompt la sauvegarde en cours
+    void cancel();
+
+public slots:
+    void run();
+
+signals:
+    // fraction de l'étape en cours (0..1)
+    void progress(double fraction, const QString &stage);
+    // errorMessage est vide si la sauvegarde a été annulée
+    void finished(bool success, const QString &errorMessage);
+
+private:
+    bool writeWav(const QString &path, QString &errorMessage);
+    bool encodeWithFFmpeg(const QString &output, QString &errorMessage);
+    void readFFmpegProgress(QProcess &ff, QByteArray &pending, double durationUs);
+    bool replaceFile(const QString &source, const QString &target, QString &errorMessage);
+    QString siblingTempPath() const;
+
+    Request request;
+    std::atomic<bool> cancelRequested{false};
+};
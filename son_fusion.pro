@@ -3,7 +3,7 @@
 # Windows, macOS, Linux
 # ============================================================================
 
-QT += core gui widgets multimedia
+QT += core gui widgets multimedia concurrent
 CONFIG += c++17
 
 TARGET = son_fusion
@@ -18,19 +18,43 @@ DEFINES += USE_DIALOG_MODE
 
 SOURCES += \
     audioeditor.cpp \
+    audioloader.cpp \
     audiomerger.cpp \
+    audioplayback.cpp \
+    audioprober.cpp \
     customtooltip.cpp \
+    dspkernels.cpp \
+    edithistory.cpp \
     main.cpp \
     mainwindow.cpp \
+    peakcache.cpp \
+    peakpyramid.cpp \
+    samplebuffer.cpp \
+    sampledocument.cpp \
+    samplestore.cpp \
+    savejob.cpp \
     waveformwidget.cpp \
+    wavwriter.cpp \
     audiorecorder.cpp
 
 HEADERS += \
     audioeditor.h \
+    audioloader.h \
     audiomerger.h \
+    audioplayback.h \
+    audioprober.h \
     customtooltip.h \
+    dspkernels.h \
+    edithistory.h \
     mainwindow.h \
+    peakcache.h \
+    peakpyramid.h \
+    samplebuffer.h \
+    sampledocument.h \
+    samplestore.h \
+    savejob.h \
     waveformwidget.h \
+    wavwriter.h \
     audiorecorder.h
 
 FORMS += \
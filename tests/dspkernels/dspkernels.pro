@@ -0,0 +1,21 @@
+# ============================================================================
+# Noyaux de calcul : chaque variante (AVX2, SSE2, NEON) comparée au bit près
+# à la version scalaire, et débit de chacune
+# ============================================================================
+
+QT += testlib
+QT -= gui
+CONFIG += c++17 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_dspkernels
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_dspkernels.cpp \
+    $$PWD/../../dspkernels.cpp
+
+HEADERS += \
+    $$PWD/../../dspkernels.h
@@ -0,0 +1,420 @@
+#include <QtTest>
+
+#include "dspkernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// Longueurs impaires et autour des largeurs de vecteur (4, 8, 16) : la fin de
+// chaque boucle vectorielle passe par la version scalaire. Les décalages
+// désalignent le début des tableaux d'entrée et de sortie.
+static const int LENGTHS[] = { 0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 65, 255, 1023, 1025, 4099 };
+static const int OFFSETS[] = { 0, 1, 2, 3 };
+static const int MAX_LENGTH = 4099;
+static const int MAX_CHANNELS = 8;
+
+// Valeurs limites mêlées au bruit : pleine échelle, hors de [-1, 1],
+// demi-pas de quantification (arrondi au pair), dénormalisés, zéros signés
+static const float SPECIAL_VALUES[] = {
+    0.0f, -0.0f, 1.0f, -1.0f, 1.5f, -1.5f, 1e9f, -1e9f,
+    0.5f / 32768.0f, 1.5f / 32768.0f, 2.5f / 32768.0f, -0.5f / 32768.0f, -1.5f / 32768.0f,
+    0.5f / 8388608.0f, 1.5f / 8388608.0f, -2.5f / 8388608.0f,
+    32767.5f / 32768.0f, -32768.5f / 32768.0f,
+    0.99999994f, -0.99999994f, 1e-40f, -1e-40f
+};
+
+// Générateur congruentiel : le même signal sur toutes les plateformes
+static quint32 nextRandom(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+// Sortie repérée par variante, longueur et décalage dans les messages d'échec
+static QByteArray where(const char *isa, int length, int offset)
+{
+    return QByteArray(isa) + " n=" + QByteArray::number(length) + " décalage=" + QByteArray::number(offset);
+}
+
+// Lance kernel(n, offset, dst) en scalaire puis dans chaque variante et compare
+// les sorties au bit près, marges comprises (aucune écriture hors de la plage).
+// kernel écrit outCount(n) valeurs de type Out à partir de dst.
+template<typename Out>
+static bool compareToScalar(const QVector<const char *> &variants,
+                            const std::function<void(int, int, Out *)> &kernel,
+                            const std::function<int(int)> &outCount, QByteArray &failure)
+{
+    for (int n : LENGTHS) {
+        for (int offset : OFFSETS) {
+            const size_t size = size_t(outCount(n) + offset + 16);
+            std::vector<Out> expected(size), actual(size);
+            std::memset(expected.data(), 0xA5, size * sizeof(Out));
+
+            DspKernels::setIsa("scalar");
+            kernel(n, offset, expected.data() + offset);
+
+            for (const char *isa : variants) {
+                std::memset(actual.data(), 0xA5, size * sizeof(Out));
+                DspKernels::setIsa(isa);
+                kernel(n, offset, actual.data() + offset);
+                if (std::memcmp(expected.data(), actual.data(), size * sizeof(Out)) != 0) {
+                    failure = where(isa, n, offset);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+class TestDspKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void absMax();
+    void minMax();
+    void sumSquares();
+    void scale();
+    void clamp();
+    void floatToInt16();
+    void floatToInt24();
+    void floatToInt32();
+    void int16ToFloat();
+    void int24ToFloat();
+    void deinterleave();
+    void downmix();
+    void saturation();
+    void throughput();
+
+private:
+    QVector<const char *> variants;    // Variantes disponibles ici, hors scalaire
+    QByteArray defaultIsa;
+    std::vector<float> signal;         // Bruit dans [-1.25, 1.25] et valeurs limites
+    std::vector<qint16> pcm16;
+    std::vector<qint32> pcm32;
+    std::vector<quint8> pcm8;
+    std::vector<uchar> pcm24;          // 3 octets little-endian par échantillon
+};
+
+void TestDspKernels::initTestCase()
+{
+    defaultIsa = DspKernels::isaName();
+    for (const char *isa : { "avx2", "sse2", "neon" }) {
+        if (DspKernels::setIsa(isa))
+            variants.append(isa);
+    }
+    DspKernels::setIsa(defaultIsa.constData());
+    QVERIFY(DspKernels::setIsa("scalar"));
+    QVERIFY(!DspKernels::setIsa("inconnue"));
+    if (variants.isEmpty())
+        qInfo("Seule la variante scalaire est disponible : rien à comparer");
+
+    // De quoi lire MAX_CHANNELS canaux entrelacés depuis chaque décalage
+    const int total = (MAX_LENGTH + 4) * MAX_CHANNELS;
+    quint32 state = 12345;
+    signal.resize(total);
+    const int specialCount = int(sizeof(SPECIAL_VALUES) / sizeof(SPECIAL_VALUES[0]));
+    for (int i = 0; i < total; ++i) {
+        if (i % 7 == 3)
+            signal[i] = SPECIAL_VALUES[(i / 7) % specialCount];
+        else
+            signal[i] = (float(nextRandom(state)) / float(1 << 24) - 0.5f) * 2.5f;
+    }
+
+    pcm16.resize(total);
+    pcm32.resize(total);
+    pcm8.resize(total);
+    pcm24.resize(size_t(total) * 3);
+    for (int i = 0; i < total; ++i) {
+        const quint32 r = nextRandom(state);
+        // Les extrêmes de chaque format reviennent régulièrement
+        pcm16[i] = (i % 11 == 0) ? qint16(i % 2 ? -32768 : 32767) : qint16(r);
+        pcm32[i] = (i % 11 == 0) ? qint32(i % 2 ? -2147483647 - 1 : 2147483647) : qint32(r << 8 | r >> 16);
+        pcm8[i] = quint8(r);
+        pcm24[i * 3] = uchar(r);
+        pcm24[i * 3 + 1] = uchar(r >> 8);
+        pcm24[i * 3 + 2] = (i % 11 == 0) ? uchar(i % 2 ? 0x80 : 0x7F) : uchar(r >> 16);
+    }
+}
+
+void TestDspKernels::cleanup()
+{
+    DspKernels::setIsa(defaultIsa.constData());
+}
+
+void TestDspKernels::absMax()
+{
+    QByteArray failure;
+    const bool same = compareToScalar<float>(variants, [this](int n, int offset, float *dst) {
+        *dst = DspKernels::absMax(signal.data() + offset, n);
+    }, [](int) { return 1; }, failure);
+    QVERIFY2(same, failure.constData());
+}
+
+void TestDspKernels::minMax()
+{
+    // min et max peuvent garder l'un ou l'autre de 0.0 et -0.0 : on compare les valeurs
+    for (int n : LENGTHS) {
+        for (int offset : OFFSETS) {
+            const float *src = signal.data() + offset;
+            DspKernels::setIsa("scalar");
+            float expectedMin = 0.25f, expectedMax = 0.25f;
+            DspKernels::minMax(src, n, expectedMin, expectedMax);
+            for (const char *isa : variants) {
+                DspKernels::setIsa(isa);
+                float mn = 0.25f, mx = 0.25f;
+                DspKernels::minMax(src, n, mn, mx);
+                QVERIFY2(mn == expectedMin && mx == expectedMax, where(isa, n, offset).constData());
+            }
+        }
+    }
+}
+
+void TestDspKernels::sumSquares()
+{
+    QByteArray failure;
+    const bool same = compareToScalar<double>(variants, [this](int n, int offset, double *dst) {
+        *dst = DspKernels::sumSquares(signal.data() + offset, n);
+    }, [](int) { return 1; }, failure);
+    QVERIFY2(same, failure.constData());
+
+    // Valeur connue : 1000 x 0.5² (exact en double)
+    std::vector<float> half(1001, 0.5f);
+    for (const char *isa : variants + QVector<const char *>{ "scalar" }) {
+        DspKernels::setIsa(isa);
+        QCOMPARE(DspKernels::sumSquares(half.data() + 1, 1000), 250.0);
+    }
+}
+
+void TestDspKernels::scale()
+{
+    for (float gain : { 1.0f, -1.0f, 0.70710678f, 3.5f }) {
+        QByteArray failure;
+        const bool same = compareToScalar<float>(variants, [this, gain](int n, int offset, float *dst) {
+            DspKernels::scale(signal.data() + offset, dst, n, gain);
+        }, [](int n) { return n; }, failure);
+        QVERIFY2(same, (failure + " gain=" + QByteArray::number(gain)).constData());
+    }
+}
+
+void TestDspKernels::clamp()
+{
+    QByteArray failure;
+    bool same = compareToScalar<float>(variants, [this](int n, int offset, float *dst) {
+        DspKernels::clamp(signal.data() + offset, dst, n, -1.0f, 1.0f);
+    }, [](int n) { return n; }, failure);
+    QVERIFY2(same, failure.constData());
+
+    // Sur place (dst == src), comme pour la normalisation
+    same = compareToScalar<float>(variants, [this](int n, int offset, float *dst) {
+        std::memcpy(dst, signal.data() + offset, size_t(n) * sizeof(float));
+        DspKernels::clamp(dst, dst, n, -0.5f, 0.5f);
+    }, [](int n) { return n; }, failure);
+    QVERIFY2(same, failure.constData());
+}
+
+void TestDspKernels::floatToInt16()
+{
+    QByteArray failure;
+    const bool same = compareToScalar<qint16>(variants, [this](int n, int offset, qint16 *dst) {
+        DspKernels::floatToInt16(signal.data() + offset, dst, n);
+    }, [](int n) { return n; }, failure);
+    QVERIFY2(same, failure.constData());
+}
+
+void TestDspKernels::floatToInt24()
+{
+    QByteArray failure;
+    const bool same = compareToScalar<uchar>(variants, [this](int n, int offset, uchar *dst) {
+        DspKernels::floatToInt24(signal.data() + offset, dst, n);
+    }, [](int n) { return 3 * n; }, failure);
+    QVERIFY2(same, failure.constData());
+}
+
+void TestDspKernels::floatToInt32()
+{
+    for (int bits : { 16, 24, 32 }) {
+        const float scale = float(qint64(1) << (bits - 1));
+        QByteArray failure;
+        const bool same = compareToScalar<qint32>(variants, [this, scale, bits](int n, int offset, qint32 *dst) {
+            DspKernels::floatToInt32(signal.data() + offset, dst, n, scale, bits);
+        }, [](int n) { return n; }, failure);
+        QVERIFY2(same, (failure + " bits=" + QByteArray::number(bits)).constData());
+    }
+}
+
+void TestDspKernels::int16ToFloat()
+{
+    QByteArray failure;
+    const bool same = compareToScalar<float>(variants, [this](int n, int offset, float *dst) {
+        DspKernels::int16ToFloat(pcm16.data() + offset, dst, n);
+    }, [](int n) { return n; }, failure);
+    QVERIFY2(same, failure.constData());
+}
+
+void TestDspKernels::int24ToFloat()
+{
+    QByteArray failure;
+    const bool same = compareToScalar<float>(variants, [this](int n, int offset, float *dst) {
+        DspKernels::int24ToFloat(pcm24.data() + 3 * offset, dst, n);
+    }, [](int n) { return n; }, failure);
+    QVERIFY2(same, failure.constData());
+}
+
+void TestDspKernels::deinterleave()
+{
+    // Mono et stéréo ont leurs boucles vectorielles ; 3 et 6 canaux passent par la boucle générique
+    for (int channels : { 1, 2, 3, 6 }) {
+        auto planes = [channels](float *dst, int n, float **out) {
+            for (int c = 0; c < channels; ++c) out[c] = dst + c * n;
+        };
+        const auto count = [channels](int n) { return n * channels; };
+        QByteArray failure;
+
+        bool same = compareToScalar<float>(variants, [&](int n, int offset, float *dst) {
+            float *out[MAX_CHANNELS];
+            planes(dst, n, out);
+            DspKernels::deinterleave(signal.data() + offset, channels, n, out);
+        }, count, failure);
+        QVERIFY2(same, (failure + " float canaux=" + QByteArray::number(channels)).constData());
+
+        same = compareToScalar<float>(variants, [&](int n, int offset, float *dst) {
+            float *out[MAX_CHANNELS];
+            planes(dst, n, out);
+            DspKernels::deinterleave(pcm16.data() + offset, channels, n, out);
+        }, count, failure);
+        QVERIFY2(same, (failure + " int16 canaux=" + QByteArray::number(channels)).constData());
+
+        same = compareToScalar<float>(variants, [&](int n, int offset, float *dst) {
+            float *out[MAX_CHANNELS];
+            planes(dst, n, out);
+            DspKernels::deinterleave(pcm32.data() + offset, channels, n, out);
+        }, count, failure);
+        QVERIFY2(same, (failure + " int32 canaux=" + QByteArray::number(channels)).constData());
+
+        same = compareToScalar<float>(variants, [&](int n, int offset, float *dst) {
+            float *out[MAX_CHANNELS];
+            planes(dst, n, out);
+            DspKernels::deinterleave(pcm8.data() + offset, channels, n, out);
+        }, count, failure);
+        QVERIFY2(same, (failure + " uint8 canaux=" + QByteArray::number(channels)).constData());
+    }
+}
+
+void TestDspKernels::downmix()
+{
+    const int layouts[][2] = { { 2, 1 }, { 1, 2 }, { 2, 2 }, { 3, 1 }, { 6, 2 }, { 1, 6 } };
+    for (const auto &layout : layouts) {
+        const int srcChannels = layout[0], dstChannels = layout[1];
+        QByteArray failure;
+        const bool same = compareToScalar<float>(variants, [&](int n, int offset, float *dst) {
+            DspKernels::downmix(signal.data() + offset, srcChannels, dst, dstChannels, n);
+        }, [dstChannels](int n) { return n * dstChannels; }, failure);
+        QVERIFY2(same, (failure + " " + QByteArray::number(srcChannels) + " -> "
+                        + QByteArray::number(dstChannels)).constData());
+    }
+}
+
+void TestDspKernels::saturation()
+{
+    // Valeurs attendues, pour chaque variante. Chaque cas est répété 17 fois :
+    // il passe par la boucle vectorielle puis par la fin scalaire.
+    const float in[] = { 1.0f, -1.0f, 1.5f, -1.5f, 1e9f, -1e9f,
+                         0.5f / 32768.0f, 1.5f / 32768.0f, 2.5f / 32768.0f, -0.5f / 32768.0f, -1.5f / 32768.0f };
+    const qint16 out16[] = { 32767, -32768, 32767, -32768, 32767, -32768, 0, 2, 2, 0, -2 };
+    const int cases = int(sizeof(in) / sizeof(in[0]));
+    const int repeat = 17;
+
+    for (const char *isa : variants + QVector<const char *>{ "scalar" }) {
+        DspKernels::setIsa(isa);
+        for (int k = 0; k < cases; ++k) {
+            const std::vector<float> src(repeat, in[k]);
+            const QByteArray what = QByteArray(isa) + " x=" + QByteArray::number(double(in[k]), 'g', 9);
+
+            std::vector<qint16> s16(repeat);
+            DspKernels::floatToInt16(src.data(), s16.data(), repeat);
+            for (int i = 0; i < repeat; ++i)
+                QVERIFY2(s16[i] == out16[k], what.constData());
+
+            // 24 bits : pleine échelle à 0x7FFFFF / 0x800000
+            std::vector<uchar> s24(3 * repeat);
+            DspKernels::floatToInt24(src.data(), s24.data(), repeat);
+            for (int i = 0; i < repeat; ++i) {
+                const qint32 v = qint32(quint32(s24[3 * i]) << 8 | quint32(s24[3 * i + 1]) << 16
+                                        | quint32(s24[3 * i + 2]) << 24) >> 8;
+                const qint32 expected = k < 6 ? (in[k] > 0 ? 8388607 : -8388608)
+                                              : qint32(std::nearbyint(double(in[k]) * 8388608.0));
+                QVERIFY2(v == expected, what.constData());
+            }
+
+            // 32 bits : 2^31 - 1 n'existe pas en float, le plus grand est 2^31 - 128
+            std::vector<qint32> s32(repeat);
+            DspKernels::floatToInt32(src.data(), s32.data(), repeat, 2147483648.0f, 32);
+            for (int i = 0; i < repeat; ++i) {
+                const qint32 expected = k < 6 ? (in[k] > 0 ? 2147483520 : -2147483647 - 1)
+                                              : qint32(std::nearbyint(double(in[k]) * 2147483648.0));
+                QVERIFY2(s32[i] == expected, what.constData());
+            }
+        }
+
+        // Retour en float : -32768 et 0x800000 valent exactement -1
+        const std::vector<qint16> low16(repeat, qint16(-32768));
+        std::vector<float> f(repeat);
+        DspKernels::int16ToFloat(low16.data(), f.data(), repeat);
+        for (int i = 0; i < repeat; ++i)
+            QCOMPARE(f[i], -1.0f);
+
+        const uchar low24[] = { 0x00, 0x00, 0x80, 0xFF, 0xFF, 0x7F };
+        float f24[2];
+        DspKernels::int24ToFloat(low24, f24, 2);
+        QCOMPARE(f24[0], -1.0f);
+        QCOMPARE(f24[1], 8388607.0f / 8388608.0f);
+    }
+}
+
+void TestDspKernels::throughput()
+{
+    // Débit indicatif de chaque variante (aucun seuil : la machine de test varie)
+    const qint64 n = 1 << 20;
+    const int rounds = 20;
+    std::vector<float> src(n), dst(2 * n);
+    std::vector<qint16> s16(n);
+    for (qint64 i = 0; i < n; ++i) src[i] = signal[i % signal.size()];
+    float *planes[2] = { dst.data(), dst.data() + n };
+    volatile double sink = 0.0;
+
+    const QVector<QPair<const char *, std::function<void()>>> kernels = {
+        { "absMax",       [&]() { sink = sink + DspKernels::absMax(src.data(), n); } },
+        { "minMax",       [&]() { float mn = 0.0f, mx = 0.0f; DspKernels::minMax(src.data(), n, mn, mx); sink = sink + mx; } },
+        { "sumSquares",   [&]() { sink = sink + DspKernels::sumSquares(src.data(), n); } },
+        { "scale",        [&]() { DspKernels::scale(src.data(), dst.data(), n, 0.5f); } },
+        { "clamp",        [&]() { DspKernels::clamp(src.data(), dst.data(), n, -1.0f, 1.0f); } },
+        { "floatToInt16", [&]() { DspKernels::floatToInt16(src.data(), s16.data(), n); } },
+        { "int16ToFloat", [&]() { DspKernels::int16ToFloat(s16.data(), dst.data(), n); } },
+        { "deinterleave", [&]() { DspKernels::deinterleave(src.data(), 2, n / 2, planes); } },
+        { "downmix",      [&]() { DspKernels::downmix(src.data(), 2, dst.data(), 1, n / 2); } },
+    };
+
+    for (const char *isa : QVector<const char *>{ "scalar" } + variants) {
+        DspKernels::setIsa(isa);
+        for (const auto &kernel : kernels) {
+            kernel.second();   // Mise en cache
+            QElapsedTimer timer;
+            timer.start();
+            for (int r = 0; r < rounds; ++r) kernel.second();
+            const double seconds = std::max<qint64>(1, timer.nsecsElapsed()) * 1e-9;
+            qInfo("%-6s %-13s %8.0f Méch./s", isa, kernel.first, double(n) * rounds / seconds / 1e6);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestDspKernels)
+
+#include "tst_dspkernels.moc"
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "samplebuffer.h"
+
+#include <QVector>
+#include <algorithm>
+#include <climits>
+
+// Signaux de test plus longs que INT_MAX échantillons, sans les gigaoctets
+// correspondants : un seul bloc de PERIOD échantillons, répété par
+// SampleBuffer::insert (tous les morceaux partagent ce bloc). L'échantillon
+// pos vaut donc toujours at(pos).
+namespace LongSignal
+{
+static constexpr qint64 PERIOD = SampleBuffer::BLOCK_SIZE;
+// Première position qui ne tient plus dans un int
+static constexpr qint64 BEYOND_INT = qint64(INT_MAX) + 1;
+
+// Valeurs de [-1, 1) sans motif court, exactes en 16 bits
+inline qint16 pcmAt(qint64 pos)
+{
+    const quint32 i = quint32(pos % PERIOD);
+    return qint16(int((i * 2654435761u) >> 16) - 32768);
+}
+
+inline float at(qint64 pos)
+{
+    return pcmAt(pos) / 32768.0f;
+}
+
+inline QVector<float> period()
+{
+    QVector<float> values(static_cast<int>(PERIOD));
+    for (int i = 0; i < values.size(); ++i) values[i] = at(i);
+    return values;
+}
+
+// Signal de length échantillons : la période, puis des doublements (self-insert)
+inline SampleBuffer make(qint64 length, SampleBlock::Encoding encoding = SampleBlock::Encoding::Float32)
+{
+    SampleBuffer buffer;
+    buffer.setEncoding(encoding);
+    buffer.append(period());
+    while (buffer.size() < length)
+        buffer.insert(buffer.size(), buffer, 0, std::min(buffer.size(), length - buffer.size()));
+    buffer.remove(length, buffer.size() - length);
+    return buffer;
+}
+
+// Même chose pour channels canaux identiques
+inline MultiChannelBuffer makeChannels(int channels, qint64 length)
+{
+    MultiChannelBuffer buffer;
+    buffer.setChannelCount(channels);
+    buffer.append(QVector<QVector<float>>(channels, period()));
+    while (buffer.size() < length)
+        buffer.insert(buffer.size(), buffer, 0, std::min(buffer.size(), length - buffer.size()));
+    buffer.remove(length, buffer.size() - length);
+    return buffer;
+}
+}
@@ -0,0 +1,27 @@
+# ============================================================================
+# Pyramide de pics : requêtes et éditions au-delà de INT_MAX échantillons
+# ============================================================================
+
+QT += testlib
+QT -= gui
+CONFIG += c++17 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_peakpyramid
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../.. $$PWD/..
+
+SOURCES += \
+    tst_peakpyramid.cpp \
+    $$PWD/../../dspkernels.cpp \
+    $$PWD/../../peakpyramid.cpp \
+    $$PWD/../../samplebuffer.cpp \
+    $$PWD/../../samplestore.cpp
+
+HEADERS += \
+    $$PWD/../longsignal.h \
+    $$PWD/../../dspkernels.h \
+    $$PWD/../../peakpyramid.h \
+    $$PWD/../../samplebuffer.h \
+    $$PWD/../../samplestore.h
@@ -0,0 +1,168 @@
+#include <QtTest>
+
+#include "longsignal.h"
+#include "peakpyramid.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+
+// Pics d'un signal de plus de 2^31 échantillons : requêtes au-delà de
+// INT_MAX, sur le signal d'origine puis après une coupe et une insertion
+class TestPeakPyramid : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void peakRange_data();
+    void peakRange();
+    void wholeSignal();
+    void withoutSamples();
+    void edits();
+
+private:
+    SampleBuffer buffer;
+    PeakTrack track;
+};
+
+// Pic et énergie attendus, échantillon par échantillon
+static PeakPyramid::Peak expectedPeak(qint64 start, qint64 end, const std::function<float(qint64)> &value)
+{
+    PeakPyramid::Peak p{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+    for (qint64 i = start; i < end; ++i) {
+        const float v = value(i);
+        p.min = std::min(p.min, v);
+        p.max = std::max(p.max, v);
+        p.energy += double(v) * v;
+    }
+    return p;
+}
+
+static bool sameEnergy(double a, double b)
+{
+    return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+}
+
+void TestPeakPyramid::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    // Les pics sont calculés une fois : 2^31 échantillons lus, une période répétée.
+    // Quelques millions d'échantillons au-delà de INT_MAX pour les requêtes et les éditions.
+    buffer = LongSignal::make(LongSignal::BEYOND_INT + 4 * LongSignal::PERIOD + 12345);
+    track.build(buffer);
+    QCOMPARE(track.size(), buffer.size());
+}
+
+void TestPeakPyramid::peakRange_data()
+{
+    QTest::addColumn<qint64>("start");
+    QTest::addColumn<qint64>("end");
+
+    const qint64 m = INT_MAX;
+    // Plages courtes (échantillons bruts), et plages qui passent par les
+    // niveaux de 256, 4096 et 65536 échantillons avec des bords quelconques
+    QTest::newRow("autour de INT_MAX") << m - 1000 << m + 1000;
+    QTest::newRow("au-delà, court") << m + 7 << m + 200;
+    QTest::newRow("niveaux 0 à 2") << m - 70001 << m + 70003;
+    QTest::newRow("colonne de 3 M") << m + 5 << m + 3000005;
+    QTest::newRow("fin du signal") << buffer.size() - 300 << buffer.size();
+    QTest::newRow("au-delà de la fin") << buffer.size() - 10 << buffer.size() + 1000;
+}
+
+void TestPeakPyramid::peakRange()
+{
+    QFETCH(qint64, start);
+    QFETCH(qint64, end);
+
+    bool ok = true;
+    const PeakPyramid::Peak p = track.peakRange(&buffer, start, end, &ok);
+    const PeakPyramid::Peak e = expectedPeak(start, std::min(end, buffer.size()), LongSignal::at);
+    QVERIFY(ok);
+    QCOMPARE(p.min, e.min);
+    QCOMPARE(p.max, e.max);
+    QVERIFY2(sameEnergy(p.energy, e.energy), QByteArray::number(p.energy - e.energy).constData());
+}
+
+void TestPeakPyramid::wholeSignal()
+{
+    // Toute la période est présente : les extrêmes sont ceux de la période,
+    // l'énergie est celle des périodes complètes plus celle du reste
+    const PeakPyramid::Peak period = expectedPeak(0, LongSignal::PERIOD, LongSignal::at);
+    const qint64 rest = buffer.size() % LongSignal::PERIOD;
+    const double energy = double(buffer.size() / LongSignal::PERIOD) * period.energy
+                        + expectedPeak(0, rest, LongSignal::at).energy;
+
+    const PeakPyramid::Peak p = track.peakRange(&buffer, 0, buffer.size());
+    QCOMPARE(p.min, period.min);
+    QCOMPARE(p.max, period.max);
+    QVERIFY(sameEnergy(p.energy, energy));
+
+    // Valeur efficace d'une colonne qui finit au-delà de INT_MAX
+    const qint64 start = qint64(INT_MAX) - 500000;
+    const qint64 end = qint64(INT_MAX) + 500001;
+    const PeakPyramid::Peak column = track.peakRange(&buffer, start, end);
+    const double rms = std::sqrt(column.energy / double(end - start));
+    QVERIFY(rms > 0.5 && rms < 0.65);    // Signal uniforme sur [-1, 1) : 1/sqrt(3)
+}
+
+void TestPeakPyramid::withoutSamples()
+{
+    // Aperçu du cache disque : pyramide seule, bords approchés par les blocs de 256
+    const PeakPyramid *pyramid = track.wholePyramid();
+    QVERIFY(pyramid);
+    QCOMPARE(pyramid->sampleCount(), buffer.size());
+
+    const qint64 start = (qint64(INT_MAX) / 256 - 40) * 256;
+    const qint64 end = start + 256 * 300;
+    const PeakPyramid::Peak p = pyramid->peakRange(nullptr, start, end);
+    const PeakPyramid::Peak e = expectedPeak(start, end, LongSignal::at);
+    QCOMPARE(p.min, e.min);
+    QCOMPARE(p.max, e.max);
+    QVERIFY(sameEnergy(p.energy, e.energy));
+}
+
+void TestPeakPyramid::edits()
+{
+    SampleBuffer edited = buffer;
+    PeakTrack peaks = track;
+
+    // Coupe au-delà de INT_MAX : seuls les pics de la plage sont refaits
+    const qint64 cut = LongSignal::BEYOND_INT + 1000;
+    edited.remove(cut, 5000);
+    peaks.replace(edited, cut, 5000, 0);
+    QCOMPARE(peaks.size(), edited.size());
+    QVERIFY(!peaks.wholePyramid());
+
+    const auto afterCut = [cut](qint64 i) { return LongSignal::at(i < cut ? i : i + 5000); };
+    PeakPyramid::Peak p = peaks.peakRange(&edited, cut - 300, cut + 300);
+    PeakPyramid::Peak e = expectedPeak(cut - 300, cut + 300, afterCut);
+    QCOMPARE(p.min, e.min);
+    QCOMPARE(p.max, e.max);
+    QVERIFY(sameEnergy(p.energy, e.energy));
+
+    // Insertion de pleine échelle plus loin : le pic de la plage la voit
+    const qint64 pos = cut + 100000;
+    SampleBuffer marker;
+    marker.append(QVector<float>(5, 1.0f));
+    edited.insert(pos, marker, 0, marker.size());
+    peaks.replace(edited, pos, 0, marker.size());
+    QCOMPARE(peaks.size(), edited.size());
+
+    p = peaks.peakRange(&edited, pos - 100, pos + 100);
+    QCOMPARE(p.max, 1.0f);
+    p = peaks.peakRange(&edited, pos + 5, pos + 4000);
+    e = expectedPeak(pos, pos + 3995, afterCut);
+    QCOMPARE(p.min, e.min);
+    QCOMPARE(p.max, e.max);
+    QVERIFY(sameEnergy(p.energy, e.energy));
+
+    // Le signal d'origine et ses pics sont intacts
+    QCOMPARE(track.size(), buffer.size());
+    QVERIFY(track.wholePyramid());
+}
+
+QTEST_APPLESS_MAIN(TestPeakPyramid)
+
+#include "tst_peakpyramid.moc"
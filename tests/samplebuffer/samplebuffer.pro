@@ -0,0 +1,25 @@
+# ============================================================================
+# Signal en table de morceaux : positions au-delà de INT_MAX
+# ============================================================================
+
+QT += testlib
+QT -= gui
+CONFIG += c++17 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_samplebuffer
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../.. $$PWD/..
+
+SOURCES += \
+    tst_samplebuffer.cpp \
+    $$PWD/../../dspkernels.cpp \
+    $$PWD/../../samplebuffer.cpp \
+    $$PWD/../../samplestore.cpp
+
+HEADERS += \
+    $$PWD/../longsignal.h \
+    $$PWD/../../dspkernels.h \
+    $$PWD/../../samplebuffer.h \
+    $$PWD/../../samplestore.h
@@ -0,0 +1,187 @@
+#include <QtTest>
+
+#include "longsignal.h"
+#include "samplebuffer.h"
+
+#include <vector>
+
+Q_DECLARE_METATYPE(SampleBlock::Encoding)
+
+// Positions d'échantillon au-delà de INT_MAX : lecture, coupe, insertion et
+// gain sur des signaux de plus de 2^31 échantillons (voir LongSignal)
+class TestSampleBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void sharedBlocks();
+    void read_data();
+    void read();
+    void remove();
+    void insert();
+    void applyGain();
+    void readInterleaved();
+};
+
+void TestSampleBuffer::initTestCase()
+{
+    // Fichier d'échange dans le dossier de test, pas dans le cache de l'utilisateur
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestSampleBuffer::sharedBlocks()
+{
+    // 2^32 échantillons (16 Go en float) pour le prix d'un bloc
+    const SampleBuffer buffer = LongSignal::make(qint64(1) << 32);
+    QCOMPARE(buffer.size(), qint64(1) << 32);
+    QVERIFY(buffer.pieceCount() <= 4096);
+    QSet<const SampleBlock *> seen;
+    QCOMPARE(buffer.blockBytes(seen), LongSignal::PERIOD * qint64(sizeof(float)));
+}
+
+void TestSampleBuffer::read_data()
+{
+    QTest::addColumn<SampleBlock::Encoding>("encoding");
+    QTest::addColumn<qint64>("start");
+
+    // Autour de INT_MAX (qui est aussi une frontière de morceaux), de 2^32 et
+    // de la fin du signal
+    const struct { const char *name; qint64 start; } positions[] = {
+        { "INT_MAX - 3", qint64(INT_MAX) - 3 },
+        { "INT_MAX", INT_MAX },
+        { "2^31 + 1", LongSignal::BEYOND_INT + 1 },
+        { "3e9", 3000000000LL },
+        { "2^32 - 5", (qint64(1) << 32) - 5 },
+        { "fin", (qint64(1) << 32) + 1000 - 4 },
+    };
+    for (const auto &p : positions) {
+        QTest::newRow((QByteArray("float ") + p.name).constData()) << SampleBlock::Encoding::Float32 << p.start;
+        QTest::newRow((QByteArray("int16 ") + p.name).constData()) << SampleBlock::Encoding::Int16 << p.start;
+    }
+}
+
+void TestSampleBuffer::read()
+{
+    QFETCH(SampleBlock::Encoding, encoding);
+    QFETCH(qint64, start);
+
+    const qint64 length = (qint64(1) << 32) + 1000;
+    const SampleBuffer buffer = LongSignal::make(length, encoding);
+    QCOMPARE(buffer.size(), length);
+
+    // On demande 10 échantillons : la lecture s'arrête à la fin du signal
+    float values[10];
+    const qint64 expected = std::min<qint64>(10, length - start);
+    QCOMPARE(buffer.read(start, values, 10), expected);
+    for (qint64 i = 0; i < expected; ++i) {
+        QCOMPARE(values[i], LongSignal::at(start + i));
+        QCOMPARE(buffer.at(start + i), LongSignal::at(start + i));
+    }
+    QCOMPARE(buffer.at(length), 0.0f);
+}
+
+void TestSampleBuffer::remove()
+{
+    const qint64 length = qint64(1) << 32;
+    const SampleBuffer original = LongSignal::make(length);
+
+    // Coupe entièrement au-delà de INT_MAX
+    SampleBuffer buffer = original;
+    const qint64 start = 3000000000LL;
+    buffer.remove(start, 1000);
+    QCOMPARE(buffer.size(), length - 1000);
+    QCOMPARE(buffer.at(start - 1), LongSignal::at(start - 1));
+    for (qint64 i = 0; i < 10; ++i)
+        QCOMPARE(buffer.at(start + i), LongSignal::at(start + 1000 + i));
+    QCOMPARE(buffer.commonPrefix(original), start);
+    QCOMPARE(buffer.commonSuffix(original), length - start - 1000);
+
+    // Coupe à cheval sur INT_MAX
+    buffer = original;
+    buffer.remove(qint64(INT_MAX) - 10, 20);
+    QCOMPARE(buffer.size(), length - 20);
+    QCOMPARE(buffer.at(qint64(INT_MAX) - 11), LongSignal::at(qint64(INT_MAX) - 11));
+    QCOMPARE(buffer.at(qint64(INT_MAX) - 10), LongSignal::at(qint64(INT_MAX) + 10));
+
+    // Tout ce qui suit 2^31 : il reste exactement INT_MAX + 1 échantillons
+    buffer = original;
+    buffer.remove(LongSignal::BEYOND_INT, length);
+    QCOMPARE(buffer.size(), LongSignal::BEYOND_INT);
+}
+
+void TestSampleBuffer::insert()
+{
+    const qint64 length = qint64(1) << 32;
+    SampleBuffer buffer = LongSignal::make(length);
+
+    SampleBuffer marker;
+    marker.append(QVector<float>(5, 0.5f));
+
+    // Insertion au-delà de INT_MAX
+    const qint64 pos = 3000000000LL;
+    buffer.insert(pos, marker, 0, marker.size());
+    QCOMPARE(buffer.size(), length + 5);
+    QCOMPARE(buffer.at(pos - 1), LongSignal::at(pos - 1));
+    for (qint64 i = 0; i < 5; ++i)
+        QCOMPARE(buffer.at(pos + i), 0.5f);
+    QCOMPARE(buffer.at(pos + 5), LongSignal::at(pos));
+    QCOMPARE(buffer.at(length + 4), LongSignal::at(length - 1));
+
+    // Source lue au-delà de INT_MAX
+    SampleBuffer copy;
+    copy.insert(0, buffer, LongSignal::BEYOND_INT + 17, 10);
+    QCOMPARE(copy.size(), qint64(10));
+    for (qint64 i = 0; i < 10; ++i)
+        QCOMPARE(copy.at(i), LongSignal::at(LongSignal::BEYOND_INT + 17 + i));
+}
+
+void TestSampleBuffer::applyGain()
+{
+    const qint64 length = qint64(1) << 32;
+    const SampleBuffer original = LongSignal::make(length);
+    SampleBuffer buffer = original;
+
+    // Seuls les 100 échantillons de la plage sont recopiés
+    const qint64 start = qint64(INT_MAX) - 50;
+    QVERIFY(buffer.applyGain(start, start + 100, 0.5f));
+    QCOMPARE(buffer.size(), length);
+    QCOMPARE(buffer.at(start - 1), LongSignal::at(start - 1));
+    for (qint64 i = 0; i < 100; ++i)
+        QCOMPARE(buffer.at(start + i), LongSignal::at(start + i) * 0.5f);
+    QCOMPARE(buffer.at(start + 100), LongSignal::at(start + 100));
+
+    QCOMPARE(buffer.commonPrefix(original), start);
+    QCOMPARE(buffer.commonSuffix(original), length - start - 100);
+    QCOMPARE(buffer.absMax(start, start + 100), original.absMax(start, start + 100) * 0.5f);
+}
+
+void TestSampleBuffer::readInterleaved()
+{
+    const qint64 length = LongSignal::BEYOND_INT + 100;
+    const MultiChannelBuffer buffer = LongSignal::makeChannels(2, length);
+    QCOMPARE(buffer.size(), length);
+
+    const qint64 start = qint64(INT_MAX) - 3;
+    std::vector<float> frames(2 * 8);
+    QCOMPARE(buffer.readInterleaved(start, frames.data(), 8), qint64(8));
+    for (qint64 i = 0; i < 8; ++i) {
+        QCOMPARE(frames[2 * i], LongSignal::at(start + i));
+        QCOMPARE(frames[2 * i + 1], LongSignal::at(start + i));
+    }
+
+    // Dernières trames : la lecture s'arrête à la fin
+    QCOMPARE(buffer.readInterleaved(length - 3, frames.data(), 8), qint64(3));
+    QCOMPARE(frames[4], LongSignal::at(length - 1));
+
+    // Coupe au-delà de INT_MAX sur tous les canaux
+    MultiChannelBuffer cut = buffer;
+    cut.remove(LongSignal::BEYOND_INT, 50);
+    QCOMPARE(cut.size(), length - 50);
+    QCOMPARE(cut.channel(1).at(LongSignal::BEYOND_INT), LongSignal::at(LongSignal::BEYOND_INT + 50));
+}
+
+QTEST_APPLESS_MAIN(TestSampleBuffer)
+
+#include "tst_samplebuffer.moc"
@@ -0,0 +1,13 @@
+# ============================================================================
+# SonFusion - Tests unitaires (QtTest)
+# qmake tests.pro && make && make check
+# ============================================================================
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    dspkernels \
+    peakpyramid \
+    samplebuffer \
+    waveformwidget \
+    wavwriter
@@ -0,0 +1,83 @@
+#include <QtTest>
+
+#include "waveformwidget.h"
+
+#include <climits>
+
+// Défilement d'une vue de plus de INT_MAX pixels : la QScrollBar est bornée
+// à INT_MAX, un cran vaut alors scrollUnit pixels. Le signal est annoncé
+// (setExpectedLength) sans être chargé, comme pendant un chargement progressif.
+class TestWaveformWidget : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scrollBar_data();
+    void scrollBar();
+};
+
+void TestWaveformWidget::scrollBar_data()
+{
+    QTest::addColumn<qint64>("length");
+    QTest::addColumn<double>("samplesPerPixel");
+    QTest::addColumn<qint64>("offset");
+    QTest::addColumn<qint64>("scrollUnit");
+
+    // Vue de 1000 pixels : défilement maximal = length / samplesPerPixel - 1000
+    QTest::newRow("moins de INT_MAX pixels")
+        << qint64(INT_MAX) + 999 << 1.0 << qint64(2000000000) << qint64(1);
+    QTest::newRow("INT_MAX + 1 pixels")
+        << qint64(INT_MAX) + 1001 << 1.0 << qint64(INT_MAX) + 1 << qint64(2);
+    // 72 h à 48 kHz : 12 441 600 000 échantillons
+    QTest::newRow("72 h, 1 échantillon par pixel")
+        << 72LL * 3600 * 48000 << 1.0 << qint64(10000000000LL) << qint64(6);
+    QTest::newRow("72 h, 4 échantillons par pixel")
+        << 72LL * 3600 * 48000 << 4.0 << qint64(3000000000LL) << qint64(2);
+    QTest::newRow("72 h, vue entière")
+        << 72LL * 3600 * 48000 << 72.0 * 3600 * 48 << qint64(0) << qint64(1);
+}
+
+void TestWaveformWidget::scrollBar()
+{
+    QFETCH(qint64, length);
+    QFETCH(double, samplesPerPixel);
+    QFETCH(qint64, offset);
+    QFETCH(qint64, scrollUnit);
+
+    WaveformWidget widget;
+    widget.resize(1000, 200);
+    widget.setExpectedLength(length);
+    widget.restoreZoomState(samplesPerPixel, offset);
+    QCOMPARE(widget.getSamplesPerPixel(), samplesPerPixel);
+    QCOMPARE(widget.getScrollOffset(), offset);
+
+    QScrollBar *bar = widget.findChild<QScrollBar *>();
+    QVERIFY(bar);
+    const qint64 maxOffset = qint64(length / samplesPerPixel) - widget.width();
+
+    // Les crans couvrent tout le défilement, à moins d'un cran près
+    const qint64 maximum = bar->maximum();
+    QVERIFY(maximum * scrollUnit <= maxOffset);
+    QVERIFY(maxOffset - maximum * scrollUnit < scrollUnit);
+    QCOMPARE(qint64(bar->value()), offset / scrollUnit);
+
+    // Barre déplacée par l'utilisateur
+    bar->setValue(int(maximum / 2));
+    QCOMPARE(widget.getScrollOffset(), maximum / 2 * scrollUnit);
+    bar->setValue(int(maximum));
+    QCOMPARE(widget.getScrollOffset(), maxOffset);
+
+    // Défilement demandé par le programme, au-delà de la fin puis au début
+    widget.scrollToPixel(maxOffset + 10);
+    QCOMPARE(widget.getScrollOffset(), maxOffset);
+    QCOMPARE(qint64(bar->value()), maximum);
+    widget.scrollToPixel(0);
+    QCOMPARE(widget.getScrollOffset(), qint64(0));
+    QCOMPARE(bar->value(), 0);
+
+    QCOMPARE(widget.sampleToPixel(length - 1), qint64((length - 1) / samplesPerPixel));
+}
+
+QTEST_MAIN(TestWaveformWidget)
+
+#include "tst_waveformwidget.moc"
@@ -0,0 +1,29 @@
+# ============================================================================
+# Vue de la forme d'onde : défilement de plus de INT_MAX pixels
+# ============================================================================
+
+QT += testlib widgets
+CONFIG += c++17 testcase
+CONFIG -= app_bundle
+
+TARGET = tst_waveformwidget
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    tst_waveformwidget.cpp \
+    $$PWD/../../dspkernels.cpp \
+    $$PWD/../../peakpyramid.cpp \
+    $$PWD/../../samplebuffer.cpp \
+    $$PWD/../../sampledocument.cpp \
+    $$PWD/../../samplestore.cpp \
+    $$PWD/../../waveformwidget.cpp
+
+HEADERS += \
+    $$PWD/../../dspkernels.h \
+    $$PWD/../../peakpyramid.h \
+    $$PWD/../../samplebuffer.h \
+    $$PWD/../../sampledocument.h \
+    $$PWD/../../samplestore.h \
+    $$PWD/../../waveformwidget.h
@@ -0,0 +1,141 @@
+#include <QtTest>
+
+#include "longsignal.h"
+#include "wavwriter.h"
+
+#include <QBuffer>
+#include <QtEndian>
+
+// En-têtes RIFF / RF64 de fichiers de plus de 4 Go et de plus de INT_MAX
+// trames. L'écriture est interrompue après le premier bloc (rappel de
+// progression) : seuls l'en-tête et les premiers échantillons sont produits.
+class TestWavWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void header_data();
+    void header();
+};
+
+void TestWavWriter::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestWavWriter::header_data()
+{
+    QTest::addColumn<int>("bits");
+    QTest::addColumn<bool>("floatSamples");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<qint64>("frames");
+    QTest::addColumn<bool>("rf64");
+    QTest::addColumn<quint64>("dataSize");
+    QTest::addColumn<quint64>("riffSize");    // Taille du fichier - 8 (ds64 en RF64)
+
+    // 36 + 2 x 2147483629 = 0xFFFFFFFE : le plus long fichier 16 bits mono en RIFF
+    QTest::newRow("16 bits mono, dernier RIFF")
+        << 16 << false << 1 << qint64(2147483629) << false << quint64(4294967258ULL) << quint64(4294967294ULL);
+    QTest::newRow("16 bits mono, premier RF64")
+        << 16 << false << 1 << qint64(2147483630) << true << quint64(4294967260ULL) << quint64(4294967332ULL);
+    // Moins de INT_MAX trames, mais plus de 4 Go
+    QTest::newRow("16 bits stéréo")
+        << 16 << false << 2 << qint64(1073741829) << true << quint64(4294967316ULL) << quint64(4294967388ULL);
+    // Taille de données impaire : octet de bourrage compté dans le RIFF
+    QTest::newRow("24 bits mono, impair")
+        << 24 << false << 1 << qint64(2147483649LL) << true << quint64(6442450947ULL) << quint64(6442451044ULL);
+    QTest::newRow("float stéréo")
+        << 32 << true << 2 << qint64(2147483651LL) << true << quint64(17179869208ULL) << quint64(17179869304ULL);
+}
+
+void TestWavWriter::header()
+{
+    QFETCH(int, bits);
+    QFETCH(bool, floatSamples);
+    QFETCH(int, channels);
+    QFETCH(qint64, frames);
+    QFETCH(bool, rf64);
+    QFETCH(quint64, dataSize);
+    QFETCH(quint64, riffSize);
+
+    const MultiChannelBuffer samples = LongSignal::makeChannels(channels, frames);
+    QCOMPARE(samples.size(), frames);
+
+    WavWriter::Format format;
+    format.sampleRate = 48000;
+    format.bitsPerSample = bits;
+    format.floatSamples = floatSamples;
+
+    QBuffer out;
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    qint64 written = -1, total = -1;
+    QString error;
+    const bool done = WavWriter::write(&out, samples, format, &error, [&](qint64 w, qint64 t) {
+        written = w;
+        total = t;
+        return false;
+    });
+    QVERIFY(!done);
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(total, frames);
+    QVERIFY(written > 0 && written < frames);
+
+    const QByteArray file = out.data();
+    const char *h = file.constData();
+    auto u16 = [h](int pos) { return qFromLittleEndian<quint16>(h + pos); };
+    auto u32 = [h](int pos) { return qFromLittleEndian<quint32>(h + pos); };
+    auto u64 = [h](int pos) { return qFromLittleEndian<quint64>(h + pos); };
+
+    QCOMPARE(file.left(4), QByteArray(rf64 ? "RF64" : "RIFF"));
+    QCOMPARE(file.mid(8, 4), QByteArray("WAVE"));
+    int pos = 12;
+    if (rf64) {
+        QCOMPARE(u32(4), 0xFFFFFFFFu);
+        QCOMPARE(file.mid(pos, 4), QByteArray("ds64"));
+        QCOMPARE(u32(pos + 4), 28u);
+        QCOMPARE(u64(pos + 8), riffSize);
+        QCOMPARE(u64(pos + 16), dataSize);
+        QCOMPARE(u64(pos + 24), quint64(frames));
+        QCOMPARE(u32(pos + 32), 0u);
+        pos += 36;
+    } else {
+        QCOMPARE(quint64(u32(4)), riffSize);
+    }
+
+    QCOMPARE(file.mid(pos, 4), QByteArray("fmt "));
+    const quint32 fmtSize = u32(pos + 4);
+    const int bytesPerSample = bits / 8;
+    QCOMPARE(u16(pos + 10), quint16(channels));
+    QCOMPARE(u32(pos + 12), 48000u);
+    QCOMPARE(u32(pos + 16), quint32(48000 * channels * bytesPerSample));
+    QCOMPARE(u16(pos + 20), quint16(channels * bytesPerSample));
+    pos += 8 + int(fmtSize);
+
+    QCOMPARE(file.mid(pos, 4), QByteArray("data"));
+    QCOMPARE(u32(pos + 4), rf64 ? 0xFFFFFFFFu : quint32(dataSize));
+    pos += 8;
+
+    // Les tailles annoncées correspondent au fichier complet
+    QCOMPARE(quint64(frames) * channels * bytesPerSample, dataSize);
+    QCOMPARE(quint64(pos) - 8 + dataSize + (dataSize & 1), riffSize);
+
+    // Premier bloc écrit : les premières trames du signal
+    QCOMPARE(qint64(file.size()), pos + written * channels * bytesPerSample);
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            const char *sample = h + pos + (i * channels + c) * bytesPerSample;
+            if (floatSamples) {
+                QCOMPARE(qFromLittleEndian<float>(sample), LongSignal::at(i));
+            } else {
+                // En 16 et 24 bits, les octets de poids fort portent la valeur 16 bits exacte
+                QCOMPARE(qFromLittleEndian<qint16>(sample + bytesPerSample - 2), LongSignal::pcmAt(i));
+            }
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestWavWriter)
+
+#include "tst_wavwriter.moc"
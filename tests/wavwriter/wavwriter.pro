@@ -0,0 +1,27 @@
+# ============================================================================
+# Écriture WAV : tailles RIFF / RF64 (ds64) au-delà de 4 Go et de INT_MAX trames
+# ============================================================================
+
+QT += testlib
+QT -= gui
+CONFIG += c++17 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_wavwriter
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../.. $$PWD/..
+
+SOURCES += \
+    tst_wavwriter.cpp \
+    $$PWD/../../dspkernels.cpp \
+    $$PWD/../../samplebuffer.cpp \
+    $$PWD/../../samplestore.cpp \
+    $$PWD/../../wavwriter.cpp
+
+HEADERS += \
+    $$PWD/../longsignal.h \
+    $$PWD/../../dspkernels.h \
+    $$PWD/../../samplebuffer.h \
+    $$PWD/../../samplestore.h \
+    $$PWD/../../wavwriter.h
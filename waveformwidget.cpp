@@ -4,13 +4,18 @@
 #include <QVBoxLayout>
 #include <algorithm>
 #include <cmath>
-#include <algorithm>
+#include <limits>
+
+// Largeur d'une tuile de forme d'onde, en pixels
+static const int TILE_WIDTH = 256;
+// Mémoire des tuiles en cache : plusieurs écrans de large, à plusieurs zooms
+static const qint64 MAX_TILE_BYTES = 48 << 20;
 
 WaveformWidget::WaveformWidget(QWidget* parent)
     : QWidget(parent)
     , isLoading(false)
-    , cacheValid(false)
     , totalSamples(0)
+    , expectedSamples(0)
     , playheadSample(0)
     , selectionStartSample(-1)
     , selectionEndSample(-1)
@@ -20,11 +25,14 @@ WaveformWidget::WaveformWidget(QWidget* parent)
     , isLoaded(false)
     , samplesPerPixel(1.0) // Sera initialisé dans resetZoom()
     , offsetPixels(0)
+    , scrollUnit(1)
     , pen(Qt::blue)
     , background(Qt::white)
     , penText(Qt::black)
 {
     setMinimumHeight(150);
+    // Chaque pixel est dessiné par les tuiles : pas d'effacement préalable
+    setAttribute(Qt::WA_OpaquePaintEvent);
     QVBoxLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
     layout->setSpacing(0);
@@ -45,28 +53,141 @@ void WaveformWidget::setColors(const QColor &backgroundColor, const QColor &penC
     background = backgroundColor;
     pen = penColor;
     penText = penTextColor;
+    clearTiles();
     update();
 }
 
-void WaveformWidget::setFullWaveform(const QVector<float> &wf)
+void WaveformWidget::setDocument(const SampleDocument *doc)
 {
-    fullWaveform = wf;
-    totalSamples = fullWaveform.size();
-    
+    if (document) document->disconnect(this);
+    document = doc;
+    if (document) {
+        connect(document, &SampleDocument::reset, this, &WaveformWidget::handleDocumentReset);
+        connect(document, &SampleDocument::changed, this, &WaveformWidget::handleDocumentChanged);
+    }
+    handleDocumentReset();
+}
+
+QVector<PeakPyramid> WaveformWidget::peakPyramids() const
+{
+    QVector<PeakPyramid> result;
+    for (const PeakTrack &track : peaks) {
+        const PeakPyramid *pyramid = track.wholePyramid();
+        if (!pyramid) return QVector<PeakPyramid>();
+        result.append(*pyramid);
+    }
+    return result;
+}
+
+void WaveformWidget::handleDocumentReset()
+{
+    totalSamples = document ? document->size() : 0;
+    peaks = QVector<PeakTrack>(document ? document->channelCount() : 0);
+    for (int c = 0; c < peaks.size(); ++c)
+        peaks[c].build(document->samples().channel(c));
+
     // Si la tête de lecture ou la sélection sont au-delà de la nouvelle fin, on les ramène
     if (playheadSample > totalSamples) playheadSample = totalSamples;
     if (selectionStartSample > totalSamples) selectionStartSample = totalSamples;
     if (selectionEndSample > totalSamples) selectionEndSample = totalSamples;
 
-    cacheValid = false;
+    clearTiles();
     resetZoom();
+    update();
+}
+
+void WaveformWidget::handleDocumentChanged(qint64 start, qint64 removed, qint64 inserted)
+{
+    if (removed == 0 && start == totalSamples) {
+        appendSamples(start);
+        return;
+    }
+
+    // Modification : seuls les pics de la plage touchée sont recalculés
+    for (int c = 0; c < peaks.size(); ++c)
+        peaks[c].replace(document->samples().channel(c), start, removed, inserted);
+    totalSamples = document->size();
+
+    if (playheadSample > totalSamples) playheadSample = totalSamples;
+    if (selectionStartSample > totalSamples) selectionStartSample = totalSamples;
+    if (selectionEndSample > totalSamples) selectionEndSample = totalSamples;
+
+    // Le zoom est gardé ; le défilement est ramené dans les limites si le signal
+    // a raccourci. Les tuiles avant la plage ne changent pas : on ne redessine
+    // que les suivantes, à mesure qu'elles sont affichées.
+    updateScrollBar();
+    invalidateTilesFrom(start);
+    update();
+}
+
+void WaveformWidget::appendSamples(qint64 firstNewSample)
+{
+    totalSamples = document->size();
+    if (peaks.size() != document->channelCount()) {
+        peaks = QVector<PeakTrack>(document->channelCount());
+        clearTiles();
+    }
+    for (int c = 0; c < peaks.size(); ++c) {
+        PeakTrack &track = peaks[c];
+        document->samples().channel(c).forEachSpan(track.size(), totalSamples, [&track](const float *data, qint64 n) {
+            track.append(data, n);
+        });
+    }
+
+    // Premier bloc, ou longueur finale inconnue : la vue suit le signal entier
+    if (firstNewSample == 0 || expectedSamples <= 0) {
+        resetZoom();
+        return;
+    }
+    if (totalSamples > expectedSamples) {
+        // Le fichier est plus long qu'annoncé : la barre de défilement s'étend
+        updateScrollBar();
+    }
+
+    // Seules les tuiles qui couvrent les nouveaux échantillons sont à redessiner
+    invalidateTilesFrom(firstNewSample);
+    update();
+}
+
+void WaveformWidget::setExpectedLength(qint64 samples)
+{
+    // La longueur exacte de l'aperçu prime sur l'estimation tirée de la durée
+    expectedSamples = std::max({qint64(0), samples, previewSamples()});
+    if (totalSamples > 0 || expectedSamples > 0) resetZoom();
+}
+
+void WaveformWidget::setPreviewPeaks(const QVector<PeakPyramid> &preview)
+{
+    previewPeaks = preview;
+    clearTiles();
+    setExpectedLength(previewSamples());
+}
+
+void WaveformWidget::finishLoading()
+{
+    const double oldBaseZoom = (width() > 0) ? static_cast<double>(viewSamples()) / width() : 0.0;
+    expectedSamples = 0;
+    previewPeaks.clear();
+    isLoading = false;
+    // Au-delà du signal décodé, les tuiles montraient l'aperçu
+    invalidateTilesFrom(totalSamples);
+
+    // Si l'utilisateur n'a pas zoomé pendant le chargement, on recale la vue sur la
+    // longueur réelle (l'estimation de durée n'est jamais exacte au sample près)
+    if (oldBaseZoom <= 0 || samplesPerPixel >= oldBaseZoom * 0.999) {
+        resetZoom();
+    } else {
+        restoreZoomState(samplesPerPixel, offsetPixels);
+    }
+    update();
 }
 
 void WaveformWidget::resetSelection(const qint64 startIndex)
 {
+    updateSampleSpan(selectionStartSample, startIndex);
+    updateSampleSpan(selectionEndSample, startIndex);
     selectionStartSample = startIndex;
     selectionEndSample = startIndex;
-    update();
 }
 
 qint64 WaveformWidget::getSelectionStart() const { return selectionStartSample; }
@@ -80,8 +201,11 @@ void WaveformWidget::setPlayheadPosition(qint64 sampleIndex)
     if (sampleIndex > totalSamples)
         sampleIndex = totalSamples;
         
+    // Seules les bandes de l'ancienne et de la nouvelle position sont repeintes :
+    // pendant la lecture, la forme d'onde n'est pas redessinée
+    updateSampleSpan(playheadSample, playheadSample);
+    updateSampleSpan(sampleIndex, sampleIndex);
     playheadSample = sampleIndex;
-    update();
 }
 
 qint64 WaveformWidget::getPlayheadPosition() const { return playheadSample; }
@@ -92,8 +216,13 @@ void WaveformWidget::setStartAndEnd(qint64 pt1, qint64 pt2)
     pt1 = std::clamp(pt1, (qint64)0, totalSamples);
     pt2 = std::clamp(pt2, (qint64)0, totalSamples);
 
-    selectionStartSample = std::min(pt1, pt2);
-    selectionEndSample = std::max(pt1, pt2);
+    const qint64 newStart = std::min(pt1, pt2);
+    const qint64 newEnd = std::max(pt1, pt2);
+    // Ce qui change à l'écran est entre l'ancien et le nouveau bord, de chaque côté
+    updateSampleSpan(selectionStartSample, newStart);
+    updateSampleSpan(selectionEndSample, newEnd);
+    selectionStartSample = newStart;
+    selectionEndSample = newEnd;
     setPlayheadPosition(selectionStartSample);
 }
 
@@ -102,76 +231,194 @@ void WaveformWidget::setisLoaded(bool v)
     isLoaded = v;
 }
 
-//
-// RecalcCache() : reconstruit displayWaveform pour la zone visible
-// La taille de displayWaveform sera égale à width() (le nombre de pixels horizontaux)
-//
-void WaveformWidget::recalcCache()
+void WaveformWidget::clearTiles()
 {
-    int w = width();
-    if (w <= 0) return;
-
-    displayWaveform.resize(w);
-    // On efface le cache (remplit de 0) pour éviter les fantômes
-    std::fill(displayWaveform.begin(), displayWaveform.end(), 0.0f);
+    tiles.clear();
+    tileBytes = 0;
+}
 
-    // On vérifie la taille réelle du vecteur en mémoire
-    qint64 realSize = fullWaveform.size();
-    if (realSize <= 0) {
-        cacheValid = true;
-        return;
+void WaveformWidget::invalidateTilesFrom(qint64 sample)
+{
+    for (auto it = tiles.begin(); it != tiles.end(); ) {
+        // Première colonne touchée, relative à la tuile ; une colonne de marge :
+        // l'arrondi de la colonne de départ peut déborder
+        const qint64 firstColumn = static_cast<qint64>(sample / it.key().samplesPerPixel) - 1
+                                   - it.key().index * TILE_WIDTH;
+        if (firstColumn <= it->renderedFrom) {
+            tileBytes -= it->image.sizeInBytes();
+            it = tiles.erase(it);
+        } else {
+            // Les colonnes avant la modification restent bonnes
+            if (firstColumn < it->renderedTo) it->renderedTo = static_cast<int>(firstColumn);
+            ++it;
+        }
     }
+}
 
-    for (int x = 0; x < w; ++x) {
-        // Calcul des indices
-        qint64 startSample = static_cast<qint64>((x + offsetPixels) * samplesPerPixel);
-        qint64 endSample = static_cast<qint64>((x + offsetPixels + 1) * samplesPerPixel);
-        
-        // Bornage basique
-        if (startSample >= realSize) break; 
-        if (endSample > realSize) endSample = realSize;
+const QImage *WaveformWidget::tile(qint64 index, int from, int to)
+{
+    const TileKey key{samplesPerPixel, index};
+    auto it = tiles.find(key);
+    if (it == tiles.end()) {
+        // Éviction des tuiles les moins récemment affichées (tous zooms confondus)
+        while (tileBytes > MAX_TILE_BYTES && !tiles.isEmpty()) {
+            auto oldest = tiles.begin();
+            for (auto t = tiles.begin(); t != tiles.end(); ++t)
+                if (t->lastUse < oldest->lastUse) oldest = t;
+            tileBytes -= oldest->image.sizeInBytes();
+            tiles.erase(oldest);
+        }
+        it = tiles.insert(key, Tile());
+        it->image = QImage(QSize(TILE_WIDTH, tileHeight) * tileRatio, QImage::Format_RGB32);
+        it->image.setDevicePixelRatio(tileRatio);
+        tileBytes += it->image.sizeInBytes();
+    }
 
-        float maxVal = 0.0f;
-        
-        // --- DÉBUT DE LA BOUCLE SÉCURISÉE ---
-        for (qint64 i = startSample; i < endSample; ++i) {
-            
-            // PROTECTION CRITIQUE CONTRE LE CRASH
-            // Même si endSample dit qu'on peut y aller, on vérifie la mémoire réelle.
-            if (i >= realSize) break; 
-            
-            float v = std::abs(fullWaveform[i]);
-            if (v > maxVal)
-                maxVal = v;
+    // Seules les colonnes pas encore dessinées sont calculées ; la plage
+    // dessinée reste d'un seul tenant (la vue se décale d'un bord à l'autre).
+    // Des colonnes illisibles ne sont pas marquées dessinées : on réessaiera.
+    Tile &t = *it;
+    t.lastUse = ++tileClock;
+    if (from < to) {
+        if (t.renderedFrom >= t.renderedTo) {
+            if (!renderColumns(t.image, index, from, to)) return nullptr;
+            t.renderedFrom = from;
+            t.renderedTo = to;
+        } else {
+            if (from < t.renderedFrom) {
+                if (!renderColumns(t.image, index, from, t.renderedFrom)) return nullptr;
+                t.renderedFrom = from;
+            }
+            if (to > t.renderedTo) {
+                if (!renderColumns(t.image, index, t.renderedTo, to)) return nullptr;
+                t.renderedTo = to;
+            }
         }
-        // --- FIN DE LA BOUCLE SÉCURISÉE ---
+    }
+    return &t.image;
+}
 
-        displayWaveform[x] = maxVal;
+//
+// renderColumns() : dessine les colonnes [from, to) de la tuile index
+// (colonnes index * TILE_WIDTH + from et suivantes de la vue complète)
+// Coût proportionnel au nombre de colonnes, pas à la longueur du fichier (cf. PeakPyramid)
+//
+bool WaveformWidget::renderColumns(QImage &image, qint64 index, int from, int to)
+{
+    const int h = tileHeight;
+    QPainter painter(&image);
+    // Fond gris : "pas de données ici"
+    painter.fillRect(from, 0, to - from, h, QColor(230, 230, 230));
+
+    qint64 realSize = totalSamples;
+    qint64 previewSize = previewSamples();
+    qint64 limit = std::max(realSize, previewSize);
+    if (limit <= 0 || samplesPerPixel <= 0) return true;
+
+    // Colonnes qui contiennent du son : fond blanc et pics
+    const qint64 firstColumn = index * TILE_WIDTH;
+    int dataEnd = from;
+    while (dataEnd < to
+           && static_cast<qint64>((firstColumn + dataEnd) * samplesPerPixel) < limit)
+        ++dataEnd;
+    painter.fillRect(from, 0, dataEnd - from, h, background);
+
+    const int lanes = laneCount();
+    const int laneHeight = h / lanes;
+
+    // Dessin par lots : une ligne verticale par colonne et par couloir,
+    // pour le pic puis, par-dessus, pour la valeur efficace
+    m_lines.clear();
+    m_rmsLines.clear();
+    if (m_lines.capacity() < (dataEnd - from) * lanes) {
+        m_lines.reserve((dataEnd - from) * lanes);
+        m_rmsLines.reserve((dataEnd - from) * lanes);
     }
-    cacheValid = true;
+
+    bool ok = true;
+    for (int c = 0; c < lanes; ++c) {
+        const int laneMid = (lanes == 1) ? h / 2 : c * laneHeight + laneHeight / 2;
+        for (int x = from; x < dataEnd; ++x) {
+            qint64 startSample = static_cast<qint64>((firstColumn + x) * samplesPerPixel);
+            qint64 endSample = static_cast<qint64>((firstColumn + x + 1) * samplesPerPixel);
+            if (endSample > limit) endSample = limit;
+
+            // Le pic de la colonne vient de la pyramide : on ne lit plus chaque
+            // échantillon, seulement le niveau le plus grossier qui tient dans la colonne
+            PeakPyramid::Peak peak;
+            if ((endSample <= realSize || previewSize < endSample) && c < peaks.size())
+                peak = peaks[c].peakRange(&document->samples().channel(c), startSample, endSample, &ok);
+            else if (c < previewPeaks.size())
+                // Partie pas encore décodée : on dessine l'aperçu du cache disque
+                peak = previewPeaks[c].peakRange(nullptr, startSample, endSample);
+            const float amp = std::max(std::abs(peak.min), std::abs(peak.max));
+
+            int y = static_cast<int>(amp * (laneHeight / 2));
+            if (y == 0 && amp > 0.001f) y = 1;
+            m_lines.append(QLine(x, laneMid - y, x, laneMid + y));
+
+            // RMS de la colonne, jamais au-delà du pic
+            const qint64 n = endSample - startSample;
+            if (n > 0 && peak.energy > 0.0) {
+                const double rms = std::min<double>(std::sqrt(peak.energy / n), amp);
+                const int r = static_cast<int>(rms * (laneHeight / 2));
+                if (r > 0) m_rmsLines.append(QLine(x, laneMid - r, x, laneMid + r));
+            }
+        }
+    }
+    painter.setPen(pen);
+    painter.drawLines(m_lines);
+    // Bande RMS : couleur du tracé éclaircie vers le fond
+    const QColor rmsColor((pen.red() + background.red()) / 2, (pen.green() + background.green()) / 2,
+                          (pen.blue() + background.blue()) / 2);
+    painter.setPen(rmsColor);
+    painter.drawLines(m_rmsLines);
+
+    // Séparation entre les couloirs
+    if (lanes > 1) {
+        painter.setPen(QColor(200, 200, 200));
+        for (int c = 1; c < lanes; ++c)
+            painter.drawLine(from, c * laneHeight, to - 1, c * laneHeight);
+    }
+    return ok;
+}
+
+int WaveformWidget::viewColumn(qint64 sample) const
+{
+    if (samplesPerPixel <= 0) return 0;
+    const qint64 x = static_cast<qint64>(sample / samplesPerPixel) - offsetPixels;
+    return static_cast<int>(std::clamp<qint64>(x, -1, width() + 1));
 }
 
-void WaveformWidget::restoreZoomState(double spp, int offset) 
+void WaveformWidget::updateSampleSpan(qint64 a, qint64 b)
+{
+    const int x1 = viewColumn(std::min(a, b));
+    const int x2 = viewColumn(std::max(a, b));
+    // Marge pour le trait de 2 pixels de la tête de lecture
+    update(QRect(x1 - 2, 0, x2 - x1 + 5, height()));
+}
+
+qint64 WaveformWidget::maxScrollOffset() const
+{
+    if (samplesPerPixel <= 0) return 0;
+    const qint64 totalPixels = static_cast<qint64>(viewSamples() / samplesPerPixel);
+    return std::max<qint64>(0, totalPixels - width());
+}
+
+void WaveformWidget::restoreZoomState(double spp, qint64 offset) 
 {
     // 1. Appliquer le zoom
     if (spp < 1.0) spp = 1.0;
     samplesPerPixel = spp;
 
     // 2. Recalculer la limite max du scroll pour la NOUVELLE taille de fichier
-    if (samplesPerPixel > 0) {
-        int totalPixels = static_cast<int>(totalSamples / samplesPerPixel);
-        int maxOffset = std::max(0, totalPixels - width());
-
-        // 3. Clamper l'offset demandé pour qu'il ne dépasse pas le max
-        if (offset > maxOffset) offset = maxOffset;
-        if (offset < 0) offset = 0;
-    }
+    // 3. Clamper l'offset demandé pour qu'il ne dépasse pas le max
+    offset = std::clamp<qint64>(offset, 0, maxScrollOffset());
 
     offsetPixels = offset;
     
     // 4. Mettre à jour l'IHM
     updateScrollBar();
-    cacheValid = false;
     update();
 }
 
@@ -182,37 +429,36 @@ void WaveformWidget::updateScrollBar()
 {
     if (samplesPerPixel <= 0) return; // Sécurité division par zéro
     
-    int totalPixels = static_cast<int>(totalSamples / samplesPerPixel);
-    int maxOffset = std::max(0, totalPixels - width());
+    const qint64 maxOffset = maxScrollOffset();
     
     // Si on a coupé la fin, l'offset actuel peut être hors limites. On le ramène.
     if (offsetPixels > maxOffset) {
         offsetPixels = maxOffset;
     }
 
-    scrollBar->setMaximum(maxOffset);
-    scrollBar->setPageStep(width());
-    
+    // Au-delà de INT_MAX pixels, un cran de la barre vaut plusieurs pixels
+    scrollUnit = 1 + maxOffset / std::numeric_limits<int>::max();
+
     // On bloque les signaux pour ne pas rappeler handleScrollChanged inutilement
     bool oldState = scrollBar->blockSignals(true);
-    scrollBar->setValue(offsetPixels);
+    scrollBar->setMaximum(static_cast<int>(maxOffset / scrollUnit));
+    scrollBar->setPageStep(std::max(1, static_cast<int>(width() / scrollUnit)));
+    scrollBar->setValue(static_cast<int>(offsetPixels / scrollUnit));
     scrollBar->blockSignals(oldState);
 }
 
 //
-// paintEvent() : utilise displayWaveform (recalculé si besoin)
+// paintEvent() : compose les tuiles de forme d'onde (dessinées si besoin) et,
+// par-dessus, la fin du signal, la sélection et la tête de lecture.
+// Seule la zone à repeindre (event->rect()) est recomposée.
 //
 void WaveformWidget::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event);
     QPainter painter(this);
-    
-    // 1. Dessiner le fond global (Zone "Vide" par défaut)
-    // On utilise un gris clair pour dire "pas de données ici"
-    painter.fillRect(rect(), QColor(230, 230, 230)); 
 
-        // --- CAS 1 : CHARGEMENT EN COURS (Prioritaire) ---
-    if (isLoading) {
+        // --- CAS 1 : CHARGEMENT EN COURS, RIEN DE DÉCODÉ ENCORE (Prioritaire) ---
+    if (isLoading && totalSamples == 0 && previewSamples() == 0) {
+        painter.fillRect(rect(), QColor(230, 230, 230));
         painter.setPen(penText);
         // On peut mettre une police un peu plus grosse ou différente si on veut
         QFont f = painter.font();
@@ -222,97 +468,112 @@ void WaveformWidget::paintEvent(QPaintEvent* event)
         return; // On s'arrête là, on ne dessine rien d'autre
     }
 
-    // // --- CAS 2 : PAS DE DONNÉES ---
-    // if (fullWaveform.isEmpty() || totalSamples <= 0) {
-    //     painter.setPen(penText);
-    //     painter.drawText(rect(), Qt::AlignCenter, tr("Aucun fichier audio chargé"));
-    //     return;
-    // }
-
-    if (!cacheValid) recalcCache();
-
     int w = width();
     int h = height();
-    int midY = h / 2;
-
-    // 2. Calculer où s'arrête le son visuellement
-    int audioEndPixel = 0;
-    if (samplesPerPixel > 0) {
-        audioEndPixel = static_cast<int>(totalSamples / samplesPerPixel) - offsetPixels;
-    }
 
-    // 3. Dessiner la zone "Blanche" (Zone Audio active)
-    // On ne dessine le blanc que là où il y a du son
-    if (audioEndPixel > 0) {
-        int drawWidth = std::min(w, audioEndPixel);
-        painter.fillRect(0, 0, drawWidth, h, background);
+    // Les tuiles dépendent de la hauteur et de la densité de pixels de l'écran
+    if (tileHeight != h || tileRatio != devicePixelRatioF()) {
+        clearTiles();
+        tileHeight = h;
+        tileRatio = devicePixelRatioF();
     }
 
-    // 4. Dessiner la forme d'onde (Optimisation par lots)
-    painter.setPen(pen);
-    int maxX = std::min(w, (int)displayWaveform.size());
-    if (audioEndPixel < maxX) maxX = audioEndPixel; 
-
-    // On vide le vecteur sans désallouer la mémoire (très rapide)
-    m_lines.clear();
-    
-    // On s'assure qu'il a assez de capacité (allouera seulement si la fenêtre s'agrandit)
-    if (m_lines.capacity() < maxX) {
-        m_lines.reserve(maxX);
+    // 1. Forme d'onde : seules les colonnes de la zone à repeindre sont copiées
+    // depuis les tuiles (et calculées, la première fois qu'elles sont vues)
+    paintedSamplesPerPixel = samplesPerPixel;
+    for (const QRect &r : event->region()) {
+        const qint64 left = offsetPixels + std::max(0, r.left());
+        const qint64 right = offsetPixels + std::min(w, r.right() + 1);
+        for (qint64 i = left / TILE_WIDTH; i * TILE_WIDTH < right; ++i) {
+            const qint64 tileX = i * TILE_WIDTH;
+            const int from = static_cast<int>(std::max(left, tileX) - tileX);
+            const int to = static_cast<int>(std::min(right, tileX + TILE_WIDTH) - tileX);
+            const QRectF target(tileX - offsetPixels + from, 0, to - from, h);
+            const QImage *image = tile(i, from, to);
+            // Échantillons illisibles (fichier d'échange inaccessible) : zone laissée vide
+            if (!image) {
+                painter.fillRect(target, QColor(230, 230, 230));
+                continue;
+            }
+            painter.drawImage(target, *image,
+                              QRectF(from * tileRatio, 0, (to - from) * tileRatio, h * tileRatio));
+        }
     }
 
-    for (int x = 0; x < maxX; ++x) {
-        float amp = displayWaveform[x];
-        int y = static_cast<int>(amp * (h / 2));
-        if (y == 0 && amp > 0.001f) y = 1; 
-        
-        m_lines.append(QLine(x, midY - y, x, midY + y));
-    }
-    
-    painter.drawLines(m_lines);
-    
-    // (Optionnel) Ajouter une petite ligne verticale grise pour marquer la fin exacte du fichier
+    // 2. Petite ligne verticale grise pour marquer la fin exacte du fichier
+    int audioEndPixel = viewColumn(std::max(totalSamples, previewSamples()));
     if (audioEndPixel >= 0 && audioEndPixel < w) {
         painter.setPen(QColor(150, 150, 150));
         painter.drawLine(audioEndPixel, 0, audioEndPixel, h);
     }
 
-    // 5. Dessiner la sélection
+    // 3. Dessiner la sélection
     if (hasSelection()) {
-        double sPixel = selectionStartSample / samplesPerPixel;
-        double ePixel = selectionEndSample / samplesPerPixel;
-        int x1 = static_cast<int>(sPixel) - offsetPixels;
-        int x2 = static_cast<int>(ePixel) - offsetPixels;
+        int x1 = viewColumn(selectionStartSample);
+        int x2 = viewColumn(selectionEndSample);
         
         if (x2 > 0 && x1 < w) {
              painter.fillRect(QRect(x1, 0, x2 - x1, h), QColor(0, 0, 255, 50));
         }
     }
 
-    // 6. Dessiner la tête de lecture
+    // 4. Dessiner la tête de lecture
     QPen playPen(Qt::red);
     playPen.setWidth(2);
     painter.setPen(playPen);
-    int px = static_cast<int>(playheadSample / samplesPerPixel) - offsetPixels;
+    int px = viewColumn(playheadSample);
     
     // On dessine la tête même si elle est à la toute fin
     if (px >= 0 && px <= w) {
         painter.drawLine(px, 0, px, h);
     }
+
+    // 5. Chargement progressif : avancement dans le coin
+    if (isLoading) {
+        QString text = tr("Chargement...");
+        if (expectedSamples > 0) {
+            int percent = static_cast<int>(std::min<qint64>(100, totalSamples * 100 / expectedSamples));
+            text = tr("Chargement... %1 %").arg(percent);
+        }
+        painter.setPen(penText);
+        QFont f = painter.font();
+        f.setItalic(true);
+        painter.setFont(f);
+        painter.drawText(rect().adjusted(0, 4, -8, 0), Qt::AlignRight | Qt::AlignTop, text);
+    }
 }
 
-void WaveformWidget::scrollToPixel(int x) {
+void WaveformWidget::scrollToPixel(qint64 x) {
     if (samplesPerPixel <= 0) return;
-    int totalWidth = static_cast<int>(fullWaveform.size() / samplesPerPixel);
-    offsetPixels = std::clamp(x, 0, std::max(0, totalWidth - width()));
+    setScrollOffset(std::clamp<qint64>(x, 0, maxScrollOffset()));
     updateScrollBar();
-    cacheValid = false; 
-    update();
 }
 
-int WaveformWidget::sampleToPixel(qint64 sample) const {
+void WaveformWidget::setScrollOffset(qint64 offset)
+{
+    const qint64 dx = offsetPixels - offset;
+    offsetPixels = offset;
+    // Le zoom a changé depuis le dernier dessin : toute la vue est à repeindre,
+    // même si le décalage, lui, n'a pas bougé (début ou fin du défilement)
+    if (samplesPerPixel != paintedSamplesPerPixel) {
+        update();
+        return;
+    }
+    if (dx == 0) return;
+
+    // Même zoom et décalage de moins d'une largeur : les pixels déjà affichés
+    // sont déplacés (copie), seules les |dx| colonnes découvertes passent par
+    // paintEvent. La barre de défilement (enfant) reste en place. Pendant le
+    // chargement, le texte d'avancement est fixe : tout est repeint.
+    if (!isLoading && std::abs(dx) < width())
+        scroll(static_cast<int>(dx), 0, QRect(0, 0, width(), scrollBar->y()));
+    else
+        update();
+}
+
+qint64 WaveformWidget::sampleToPixel(qint64 sample) const {
     if (samplesPerPixel <= 0) return 0;
-    return static_cast<int>(sample / samplesPerPixel);
+    return static_cast<qint64>(sample / samplesPerPixel);
 }
 
 
@@ -331,7 +592,7 @@ void WaveformWidget::mousePressEvent(QMouseEvent* event)
     if (sample < 0) sample = 0;
     if (sample > totalSamples) sample = totalSamples;
 
-    int threshold = static_cast<int>(5 * samplesPerPixel); 
+    qint64 threshold = static_cast<qint64>(5 * samplesPerPixel); 
     if (threshold < 5) threshold = 5;
 
     isDragging = false;
@@ -355,7 +616,6 @@ void WaveformWidget::mousePressEvent(QMouseEvent* event)
             // mais on l'annulera dans Release si c'est trop petit.
             setStartAndEnd(sample, fixedSelectionEdgeSample);
         }
-        update();
     }
 }
 
@@ -378,8 +638,8 @@ void WaveformWidget::mouseMoveEvent(QMouseEvent* event)
     if (sample < 0) sample = 0;
     if (sample > totalSamples) sample = totalSamples;
 
+    // Ne repeint que la bande entre l'ancien et le nouveau bord de la sélection
     setStartAndEnd(sample, fixedSelectionEdgeSample);
-    update();
 }
 
 void WaveformWidget::mouseReleaseEvent(QMouseEvent* event)
@@ -425,17 +685,15 @@ void WaveformWidget::mouseReleaseEvent(QMouseEvent* event)
     isDragging = false;
     isSelecting = false;
     fixedSelectionEdgeSample = -1;
-    update();
 }
 
 void WaveformWidget::resizeEvent(QResizeEvent *event)
 {
     QWidget::resizeEvent(event);
     
-    // 1. On invalide le cache : la largeur en pixels a changé, 
-    // il faut recalculer le nombre de points à afficher.
-    cacheValid = false;
-    // 2. On met à jour la scrollbar : la taille de la "page" (partie visible) a changé.
+    // Les tuiles ne dépendent pas de la largeur : une vue plus large affiche
+    // simplement plus de tuiles (la hauteur, elle, est vérifiée au dessin).
+    // On met à jour la scrollbar : la taille de la "page" (partie visible) a changé.
     updateScrollBar();
 }
 
@@ -472,18 +730,18 @@ void WaveformWidget::zoomIn()
     if (width() > 0) {
         int centerPixel = width() / 2;
         // Le nouvel offset = (PositionAbsolueDuSample - MoitiéEcran)
-        int newOffset = static_cast<int>(anchorSample / samplesPerPixel) - centerPixel;
+        qint64 newOffset = static_cast<qint64>(anchorSample / samplesPerPixel) - centerPixel;
         
-        // On utilise scrollToPixel qui gère les limites (<0 et >max) et invalide le cache
+        // On utilise scrollToPixel qui gère les limites (<0 et >max) ; le zoom
+        // ayant changé, toute la vue est repeinte
         scrollToPixel(newOffset);
     } else {
-        cacheValid = false;
         updateScrollBar();
         update();
     }
     
     // Emission signal pour UI
-    double baseZoom = (width() > 0) ? static_cast<double>(totalSamples) / width() : 1.0;
+    double baseZoom = (width() > 0) ? static_cast<double>(viewSamples()) / width() : 1.0;
     if (samplesPerPixel <= 0) samplesPerPixel = 1.0;
     
     emit zoomChanged(QString("x%1").arg(baseZoom / samplesPerPixel, 0, 'f', 1));
@@ -499,7 +757,7 @@ void WaveformWidget::zoomOut()
     // 1. Sauvegarder la position
     qint64 anchorSample = playheadSample;
     
-    double baseZoom = static_cast<double>(totalSamples) / width();
+    double baseZoom = static_cast<double>(viewSamples()) / width();
     
     // 2. Appliquer le zoom
     samplesPerPixel *= 1.25;
@@ -509,10 +767,9 @@ void WaveformWidget::zoomOut()
     // 3. Recalculer l'offset pour centrer la tête de lecture
     if (width() > 0) {
         int centerPixel = width() / 2;
-        int newOffset = static_cast<int>(anchorSample / samplesPerPixel) - centerPixel;
+        qint64 newOffset = static_cast<qint64>(anchorSample / samplesPerPixel) - centerPixel;
         scrollToPixel(newOffset);
     } else {
-        cacheValid = false;
         updateScrollBar();
         update();
     }
@@ -523,9 +780,11 @@ void WaveformWidget::zoomOut()
 
 void WaveformWidget::handleScrollChanged(int value)
 {
-    offsetPixels = value;
-    cacheValid = false;
-    update();
+    // Le dernier cran mène à la fin, même si elle ne tombe pas sur un multiple de scrollUnit
+    if (value >= scrollBar->maximum())
+        setScrollOffset(maxScrollOffset());
+    else
+        setScrollOffset(std::min(qint64(value) * scrollUnit, maxScrollOffset()));
 }
 
 //
@@ -533,10 +792,9 @@ void WaveformWidget::handleScrollChanged(int value)
 //
 void WaveformWidget::resetZoom()
 {
-    if (width() > 0 && totalSamples > 0) {
-        samplesPerPixel = static_cast<double>(totalSamples) / width();
+    if (width() > 0 && viewSamples() > 0) {
+        samplesPerPixel = static_cast<double>(viewSamples()) / width();
         offsetPixels = 0;
-        cacheValid = false;
         updateScrollBar();
         update();
         emit zoomChanged("x1.0");
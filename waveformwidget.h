@@ -3,7 +3,12 @@
 #include <QWidget>
 #include <QVector>
 #include <QColor>
+#include <QHash>
+#include <QImage>
 #include <QScrollBar>
+#include <algorithm>
+#include "peakpyramid.h"
+#include "sampledocument.h"
 
 class WaveformWidget : public QWidget {
     Q_OBJECT
@@ -13,8 +18,18 @@ public:
     // Configure les couleurs
     void setColors(const QColor &backgroundColor, const QColor &penColor, const QColor &penTextColor);
 
-    // Passe le signal complet (brut) à afficher
-    void setFullWaveform(const QVector<float> &fullWaveform);
+    // Signal à afficher, un couloir par canal. Le document reste à l'éditeur :
+    // la forme d'onde le lit directement et suit ses modifications (ajouts du
+    // chargement progressif, coupes, normalisations, annulations).
+    void setDocument(const SampleDocument *document);
+
+    // Longueur finale attendue (0 si inconnue) : fixe l'échelle pendant le chargement
+    void setExpectedLength(qint64 samples);
+    void finishLoading();
+    // Pics issus du cache disque : affichés tant que le signal n'est pas décodé
+    void setPreviewPeaks(const QVector<PeakPyramid> &preview);
+    // Une pyramide par canal, pour le cache disque ; vide si le signal a été modifié
+    QVector<PeakPyramid> peakPyramids() const;
 
     void resetSelection(const qint64 startIndex);
     qint64 getSelectionStart() const;
@@ -29,10 +44,10 @@ public:
     void resetZoom();
     // Expose l’état courant de zoom (samplesPerPixel) et d’offset (scroll)
     double getSamplesPerPixel() const { return samplesPerPixel; }
-    int    getScrollOffset()    const { return offsetPixels; }
-    int sampleToPixel(qint64 sample) const;
-    void scrollToPixel(int x);
-    void restoreZoomState(double spp, int offset);
+    qint64 getScrollOffset()    const { return offsetPixels; }
+    qint64 sampleToPixel(qint64 sample) const;
+    void scrollToPixel(qint64 x);
+    void restoreZoomState(double spp, qint64 offset);
     void setLoading(bool loading); 
 
 signals:
@@ -50,21 +65,80 @@ protected:
     
 private slots:
     void handleScrollChanged(int value);
+    void handleDocumentReset();
+    void handleDocumentChanged(qint64 start, qint64 removed, qint64 inserted);
 
 private:
-    // Recalcule la représentation downsamplée pour la zone visible
-    void recalcCache();
+    // Ajout en fin de signal pendant le chargement
+    void appendSamples(qint64 firstNewSample);
+
+    // Tuile : forme d'onde déjà dessinée de TILE_WIDTH colonnes (colonnes
+    // index * TILE_WIDTH et suivantes, comptées depuis le début du signal),
+    // pour un zoom donné. Le défilement, la tête de lecture et la sélection ne
+    // font que recomposer des tuiles existantes. Une tuile est remplie colonne
+    // par colonne, à mesure que la vue les découvre : seules les colonnes
+    // [renderedFrom, renderedTo) de l'image sont dessinées.
+    struct TileKey {
+        double samplesPerPixel;
+        qint64 index;
+        bool operator==(const TileKey &other) const
+        { return samplesPerPixel == other.samplesPerPixel && index == other.index; }
+    };
+    friend size_t qHash(const TileKey &key, size_t seed = 0)
+    { return qHashMulti(seed, key.samplesPerPixel, key.index); }
+    struct Tile {
+        QImage image;
+        int renderedFrom = 0;
+        int renderedTo = 0;
+        quint64 lastUse = 0;
+    };
+    // Tuile index au zoom courant, avec au moins ses colonnes [from, to) dessinées ;
+    // nullptr si des échantillons de ces colonnes n'ont pas pu être lus
+    const QImage *tile(qint64 index, int from, int to);
+    // Faux si un bloc d'échantillons était illisible
+    bool renderColumns(QImage &image, qint64 index, int from, int to);
+    void clearTiles();
+    // Les tuiles (de tous les zooms) qui montrent sample ou la suite sont à redessiner
+    void invalidateTilesFrom(qint64 sample);
+
+    // Colonne de la vue qui affiche sample, bornée à [-1, width() + 1]
+    int viewColumn(qint64 sample) const;
+    // Repeint la bande de la vue entre deux positions (tête de lecture, bords de sélection)
+    void updateSampleSpan(qint64 a, qint64 b);
+
+    // Longueur couverte par la vue : le signal décodé ou la longueur attendue
+    qint64 viewSamples() const { return std::max(totalSamples, expectedSamples); }
+    // Longueur couverte par l'aperçu du cache disque
+    qint64 previewSamples() const { return previewPeaks.isEmpty() ? 0 : previewPeaks[0].sampleCount(); }
+    // Nombre de couloirs affichés (canaux du signal, ou de l'aperçu)
+    int laneCount() const { return std::max<int>(1, std::max(peaks.size(), previewPeaks.size())); }
     // Met à jour la barre de défilement
     void updateScrollBar();
+    // Change le défilement : au même zoom, l'image affichée est décalée et seules
+    // les colonnes découvertes sont repeintes
+    void setScrollOffset(qint64 offset);
+    // Plus grand décalage possible pour le zoom courant
+    qint64 maxScrollOffset() const;
 
-    // Signal complet (tous les échantillons)
-    QVector<float> fullWaveform;
-    // Représentation downsamplée calculée pour la largeur (cache)
-    QVector<float> displayWaveform;
-    bool cacheValid; // vrai si displayWaveform est à jour
+    // Signal complet (tous les échantillons, tous les canaux), appartenant à l'éditeur
+    const SampleDocument *document = nullptr;
+    // Résumé min/max multi-résolution de chaque canal, mis à jour plage par plage
+    QVector<PeakTrack> peaks;
+    // Aperçu (cache disque) de la partie pas encore décodée
+    QVector<PeakPyramid> previewPeaks;
+    // Tuiles déjà dessinées, les moins récemment affichées sont évincées
+    QHash<TileKey, Tile> tiles;
+    qint64 tileBytes = 0;
+    quint64 tileClock = 0;
+    // Hauteur et densité de pixels des tuiles en cache
+    int tileHeight = 0;
+    qreal tileRatio = 0;
+    // Zoom de l'image affichée (dernier dessin) : un décalage n'est possible qu'à ce zoom
+    double paintedSamplesPerPixel = 0;
 
     // Nombre total d'échantillons (du signal complet)
     qint64 totalSamples;
+    qint64 expectedSamples; // Longueur annoncée pendant un chargement progressif
     qint64 playheadSample;
     qint64 selectionStartSample;
     qint64 selectionEndSample;
@@ -77,13 +151,17 @@ private:
     int pressStartX; 
     // Facteur de zoom : nombre d'échantillons du signal complet par pixel dans la vue courante
     double samplesPerPixel;
-    int offsetPixels; // décalage horizontal (scroll en pixels)
+    qint64 offsetPixels; // décalage horizontal (scroll en pixels)
+    // Pixels par cran de la barre de défilement : une QScrollBar est bornée
+    // à INT_MAX, ce que dépasse un enregistrement de plusieurs jours zoomé
+    qint64 scrollUnit;
 
     QColor pen;
     QColor background;
     QColor penText;
 
     QVector<QLine> m_lines;
+    QVector<QLine> m_rmsLines;
     QScrollBar *scrollBar;
 
     bool isLoading;
@@ -0,0 +1,200 @@
+#include "wavwriter.h"
+#include "dspkernels.h"
+
+#include <QIODevice>
+#include <QObject>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// Échantillons convertis par passe : 4 Mo de float, au plus 4 Mo de PCM
+static const qint64 CHUNK_SAMPLES = 1 << 20;
+
+// ============================================================================
+// DITHER
+// ============================================================================
+
+// Dither TPDF : différence de deux bruits uniformes, amplitude ±1 LSB.
+// Générateur xorshift32 : rapide, et la qualité statistique suffit largement ici.
+static void addTpdfDither(float *samples, qint64 n, int bitsPerSample, quint32 &state)
+{
+    const float lsb = 1.0f / float(qint64(1) << (bitsPerSample - 1));
+    const float norm = lsb / 4294967296.0f;
+    for (qint64 i = 0; i < n; ++i) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        const quint32 r1 = state;
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        const quint32 r2 = state;
+        samples[i] += (float(r1) - float(r2)) * norm;
+    }
+}
+
+// ============================================================================
+// EN-TÊTE RIFF / RF64
+// ============================================================================
+
+static void putTag(QByteArray &h, const char *tag) { h.append(tag, 4); }
+
+static void putU16(QByteArray &h, quint16 v)
+{
+    char b[2];
+    qToLittleEndian(v, b);
+    h.append(b, 2);
+}
+
+static void putU32(QByteArray &h, quint32 v)
+{
+    char b[4];
+    qToLittleEndian(v, b);
+    h.append(b, 4);
+}
+
+static void putU64(QByteArray &h, quint64 v)
+{
+    char b[8];
+    qToLittleEndian(v, b);
+    h.append(b, 8);
+}
+
+// Masque de positions des haut-parleurs (WAVEFORMATEXTENSIBLE) pour les
+// dispositions usuelles, dans l'ordre de FFmpeg
+static quint32 channelMask(int channels)
+{
+    switch (channels) {
+    case 1: return 0x4;         // Centre
+    case 2: return 0x3;         // Gauche, droite
+    case 3: return 0x7;
+    case 4: return 0x33;        // Quadriphonie
+    case 5: return 0x37;
+    case 6: return 0x3F;        // 5.1
+    case 7: return 0x13F;
+    case 8: return 0x63F;       // 7.1
+    default: return 0;          // Positions non précisées
+    }
+}
+
+QByteArray WavWriter::header(const Format &format, int channels, qint64 frames)
+{
+    const int bytesPerSample = format.bitsPerSample / 8;
+    const quint64 dataSize = quint64(frames) * channels * bytesPerSample;
+    const quint64 pad = dataSize & 1;   // Les blocs RIFF ont une taille paire
+
+    // WAVE_FORMAT_EXTENSIBLE au-delà de 16 bits ou de 2 canaux, comme le
+    // recommande la spécification
+    const bool extensible = format.bitsPerSample > 16 || channels > 2;
+    const quint16 formatTag = format.floatSamples ? 3 : 1;
+    const quint32 fmtSize = extensible ? 40 : 16;
+
+    const quint64 riffSize = 4 + (8 + fmtSize) + (8 + dataSize + pad);
+    const bool rf64 = riffSize > 0xFFFFFFFFull;
+
+    QByteArray h;
+    putTag(h, rf64 ? "RF64" : "RIFF");
+    putU32(h, rf64 ? 0xFFFFFFFFu : quint32(riffSize));
+    putTag(h, "WAVE");
+
+    if (rf64) {
+        // Les vraies tailles, le RIFF et le "data" valant 0xFFFFFFFF
+        putTag(h, "ds64");
+        putU32(h, 28);
+        putU64(h, riffSize + 8 + 28);
+        putU64(h, dataSize);
+        putU64(h, quint64(frames));
+        putU32(h, 0);                   // Pas de table d'autres tailles
+    }
+
+    putTag(h, "fmt ");
+    putU32(h, fmtSize);
+    putU16(h, extensible ? 0xFFFE : formatTag);
+    putU16(h, channels);
+    putU32(h, quint32(format.sampleRate));
+    putU32(h, quint32(format.sampleRate * channels * bytesPerSample));
+    putU16(h, quint16(channels * bytesPerSample));
+    putU16(h, quint16(format.bitsPerSample));
+    if (extensible) {
+        // GUID KSDATAFORMAT_SUBTYPE_xxx : les 2 premiers octets sont le format
+        uchar subFormat[16] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+        subFormat[0] = uchar(formatTag);
+        putU16(h, 22);
+        putU16(h, quint16(format.bitsPerSample));     // Bits utiles
+        putU32(h, channelMask(channels));
+        h.append(reinterpret_cast<const char *>(subFormat), 16);
+    }
+
+    putTag(h, "data");
+    putU32(h, rf64 ? 0xFFFFFFFFu : quint32(dataSize));
+    return h;
+}
+
+// ============================================================================
+// ÉCRITURE
+// ============================================================================
+
+bool WavWriter::write(QIODevice *out, const MultiChannelBuffer &samples, const Format &format,
+                      QString *errorMessage, const ProgressCallback &progress)
+{
+    auto fail = [&](const QString &message) {
+        if (errorMessage) *errorMessage = message;
+        return false;
+    };
+
+    const int bits = format.bitsPerSample;
+    if (bits != 16 && bits != 24 && bits != 32)
+        return fail(QObject::tr("Format WAV non pris en charge (%1 bits).").arg(bits));
+    if (format.floatSamples && bits != 32)
+        return fail(QObject::tr("Format WAV non pris en charge (float %1 bits).").arg(bits));
+
+    const int channels = std::max(1, samples.channelCount());
+    const qint64 frames = samples.size();
+    const QByteArray h = header(format, channels, frames);
+    if (out->write(h) != h.size())
+        return fail(out->errorString());
+
+    // Trames par passe : toujours environ CHUNK_SAMPLES valeurs
+    const qint64 chunkFrames = std::min(std::max<qint64>(1, CHUNK_SAMPLES / channels), std::max<qint64>(frames, 1));
+    std::unique_ptr<float[]> scratch(new float[chunkFrames * channels]);
+    std::unique_ptr<qint32[]> pcm(new qint32[chunkFrames * channels]);   // Assez pour tous les formats
+    quint32 ditherState = 0x9E3779B9u;
+
+    for (qint64 start = 0; start < frames; start += chunkFrames) {
+        const qint64 read = samples.readInterleaved(start, scratch.get(), std::min(chunkFrames, frames - start));
+        if (read < 0)
+            return fail(QObject::tr("Impossible de lire les échantillons (fichier d'échange inaccessible et mémoire insuffisante)."));
+        const qint64 n = read * channels;
+
+        const bool dither = format.dither && bits < 32;
+        if (dither) addTpdfDither(scratch.get(), n, bits, ditherState);
+
+        // Quantification : round(clamp(x) * 2^(bits-1)), bornée au plus grand
+        // entier représentable (ex. 32767/32768 en 16 bits)
+        qint64 bytes = 0;
+        if (format.floatSamples) {
+            // Float : les valeurs sont écrites telles quelles (little-endian en mémoire)
+            std::memcpy(pcm.get(), scratch.get(), n * sizeof(float));
+            bytes = n * 4;
+        } else if (bits == 16) {
+            DspKernels::floatToInt16(scratch.get(), reinterpret_cast<qint16 *>(pcm.get()), n);
+            bytes = n * 2;
+        } else if (bits == 24) {
+            DspKernels::floatToInt24(scratch.get(), reinterpret_cast<uchar *>(pcm.get()), n);
+            bytes = n * 3;
+        } else {
+            DspKernels::floatToInt32(scratch.get(), pcm.get(), n, 2147483648.0f, 32);
+            bytes = n * 4;
+        }
+
+        if (out->write(reinterpret_cast<const char *>(pcm.get()), bytes) != bytes)
+            return fail(out->errorString());
+        if (progress && !progress(start + n / channels, frames))
+            return fail(QObject::tr("Écriture interrompue."));
+    }
+
+    // Octet de bourrage si le bloc "data" a une taille impaire (24 bits)
+    if ((frames * channels * (bits / 8)) & 1) {
+        if (out->write("\0", 1) != 1)
+            return fail(out->errorString());
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include "samplebuffer.h"
+#include <functional>
+
+class QIODevice;
+
+// Écriture WAV par gros blocs : conversion float -> entier vectorisée
+// (DspKernels, variante choisie à l'exécution) dans un tampon de quelques Mo,
+// puis une écriture par tampon. Au-delà de 4 Go de données, le fichier est écrit en RF64 (tailles
+// sur 64 bits dans un bloc "ds64"), lisible par FFmpeg et les éditeurs usuels.
+class WavWriter
+{
+public:
+    struct Format {
+        int sampleRate = 44100;
+        int bitsPerSample = 16;     // 16, 24 ou 32
+        bool floatSamples = false;  // Float IEEE 32 bits (bitsPerSample = 32), sans conversion
+        bool dither = false;        // Dither TPDF (±1 LSB) avant quantification
+    };
+
+    // Appelé après chaque bloc écrit ; renvoyer false interrompt l'écriture
+    using ProgressCallback = std::function<bool(qint64 written, qint64 total)>;
+
+    // Écrit samples (canaux entrelacés) dans out, déjà ouvert en écriture
+    static bool write(QIODevice *out, const MultiChannelBuffer &samples, const Format &format,
+                      QString *errorMessage = nullptr, const ProgressCallback &progress = nullptr);
+
+private:
+    static QByteArray header(const Format &format, int channels, qint64 frames);
+};